@@ -0,0 +1,74 @@
+#ifndef DENSEGRAPH_H
+#define DENSEGRAPH_H
+
+/*
+КЛАСИ/ТИПИ У ФАЙЛІ:
+ 24) template<class TNode> struct DenseGraph - компактне CSR-подання графа на щільних ID
+
+ПОЛЯ:
+  - DenseGraph: nodes, offsets, targets - 3
+  разом: 3
+
+НЕТРИВІАЛЬНІ МЕТОДИ:
+  (М41) DenseGraph::fromGraph(g, onEdge) - перенумерація вершин 0..V-1 і побудова CSR
+  (М42) DenseGraph::indexOf(node) - ID вершини (бінарний пошук)
+  разом: 2
+
+ПРИМІТКИ:
+  - ID вершини = її позиція в Graph::data() (std::map, тобто відсортовано), тому indexOf — бінарний пошук;
+  - ребро e вершини u лежить у [offsets[u], offsets[u+1]); порядок ребер = порядок у списку суміжності,
+    onEdge(edge) викликається саме в цьому порядку, щоб паралельно заповнити масиви атрибутів ребер.
+*/
+
+#include "Graph.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+template <typename TNode>
+struct DenseGraph {
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<TNode>         nodes;   // ID -> вершина
+    std::vector<std::uint32_t> offsets; // V + 1 елементів
+    std::vector<std::uint32_t> targets; // ID кінця кожного ребра
+
+    std::size_t size() const { return nodes.size(); }
+    std::size_t edgeCount() const { return targets.size(); }
+
+    // (М42) ID вершини або npos
+    std::uint32_t indexOf(const TNode& node) const {
+        auto it = std::lower_bound(nodes.begin(), nodes.end(), node);
+        if (it == nodes.end() || *it != node) return npos;
+        return static_cast<std::uint32_t>(it - nodes.begin());
+    }
+
+    // (М41) побудова з Graph; onEdge(const TEdge&) — для кожного ребра у CSR-порядку
+    template <typename TEdge, typename OnEdge>
+    static DenseGraph fromGraph(const Graph<TNode, TEdge>& g, OnEdge&& onEdge) {
+        DenseGraph d;
+        d.nodes.reserve(g.size());
+        d.offsets.reserve(g.size() + 1);
+        std::size_t edges = 0;
+        for (auto& [u, vec] : g.data()) { d.nodes.push_back(u); edges += vec.size(); }
+        d.targets.reserve(edges);
+
+        d.offsets.push_back(0);
+        for (auto& [u, vec] : g.data()) {
+            for (auto& [v, edge] : vec) {
+                d.targets.push_back(d.indexOf(v));
+                onEdge(edge);
+            }
+            d.offsets.push_back(static_cast<std::uint32_t>(d.targets.size()));
+        }
+        return d;
+    }
+
+    template <typename TEdge>
+    static DenseGraph fromGraph(const Graph<TNode, TEdge>& g) {
+        return fromGraph(g, [](const TEdge&) {});
+    }
+};
+
+#endif //DENSEGRAPH_H
@@ -29,6 +29,7 @@
 */
 
 #include "Graph.h"
+#include "Metrics.h" // NETSIM_METRIC_* (порожні без NETSIM_METRICS)
 #include <queue>
 #include <stack>
 #include <limits>
@@ -119,20 +120,27 @@ public:
         using QItem = std::pair<double, TNode>;
         std::priority_queue<QItem, std::vector<QItem>, std::greater<QItem>> pq;
         pq.push({0.0, start});
+        NETSIM_METRIC_ADD(HeapPushes, 1);
 
         while (!pq.empty()) {
             auto [du, u] = pq.top(); pq.pop();
-            if (du != dist[u]) continue; // пропускаємо застарілі значення
+            if (du != dist[u]) { // пропускаємо застарілі значення
+                NETSIM_METRIC_ADD(StalePops, 1);
+                continue;
+            }
+            NETSIM_METRIC_ADD(VerticesSettled, 1);
 
             // перебираємо сусідів
             auto it = g.data().find(u);
             if (it == g.data().end()) continue;
+            NETSIM_METRIC_ADD(EdgesRelaxed, it->second.size());
             for (auto& [v, w] : it->second) {
                 double nd = du + w.weight;
                 if (nd < dist[v]) { // релаксація
                     dist[v] = nd;
                     parent[v] = u;
                     pq.push({nd, v});
+                    NETSIM_METRIC_ADD(HeapPushes, 1);
                 }
             }
         }
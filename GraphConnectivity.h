@@ -0,0 +1,289 @@
+#ifndef GRAPHCONNECTIVITY_H
+#define GRAPHCONNECTIVITY_H
+
+/*
+КЛАСИ/ТИПИ У ФАЙЛІ:
+ 27) struct DfsVisitor - порожні колбеки обходу (нащадки перевизначають потрібні)
+ 28) class DepthFirstSearch - ітеративний DFS по щільних ID з власним стеком
+ 29) struct UndirectedCsr - неорієнтована основа графа (кожне ребро двічі, з власним ID)
+ 30) struct SccResult - номер компоненти сильної зв'язності для кожної вершини
+ 31) struct LowLinkVisitor - low-link на неорієнтованому графі (спільне для (М51) і (М52))
+
+ПОЛЯ:
+  - DepthFirstSearch: stack_, visited_ - 2
+  - UndirectedCsr: offsets, targets, edgeIds, multiplicity, edgeCount - 5
+  - SccResult: component, count - 2
+  - LowLinkVisitor: g, disc, low, parentEdge, children, isArticulation, bridges, counter - 8
+  разом: 17
+
+НЕТРИВІАЛЬНІ МЕТОДИ:
+  (М47) DepthFirstSearch::visit(g, root, vis) - обхід з однієї вершини
+  (М48) DepthFirstSearch::run(g, vis) - обхід усього графа (ліс DFS)
+  (М49) UndirectedCsr::fromDirected(g) - симетризація без петель; кратні ребра — одне ребро з кратністю
+  (М50) stronglyConnectedComponents(g) - алгоритм Тар'яна
+  (М51) articulationPoints(g) - точки зчленування (вершини-"єдині точки відмови")
+  (М52) bridges(g) - мости (ребра-"єдині точки відмови")
+  разом: 6
+
+ПРИМІТКИ:
+  - рекурсії немає: стек DFS — std::vector кадрів (вершина, наступне ребро), тому глибина
+    обмежена лише пам'яттю, а не стеком потоку (ланцюжки з мільйонів вершин — без проблем);
+  - алгоритми працюють по CSR (DenseGraph / UndirectedCsr): масиви замість std::set і std::map;
+  - точки зчленування і мости шукаються на неорієнтованій основі графа: канал A->B і B->A
+    вважається одним ребром, тому двосторонні зв'язки Link не маскують мости; натомість два
+    незалежні канали між A і B (у будь-якому напрямі) дають ребро кратності 2, яке мостом не є;
+  - обгортки над Graph<TNode, TEdge> повертають вершини, а не ID; консольного виводу немає.
+*/
+
+#include "Graph.h"
+#include "DenseGraph.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// колбеки обходу; Visitor — будь-який тип з такими методами (виклики статичні, без vtable)
+struct DfsVisitor {
+    void discover(std::uint32_t) {}                                   // вершину вперше побачено
+    void treeEdge(std::uint32_t, std::uint32_t, std::uint32_t) {}     // (u, v, e): v відкрито через e
+    void nonTreeEdge(std::uint32_t, std::uint32_t, std::uint32_t) {}  // (u, v, e): v вже відвідана
+    void finish(std::uint32_t, std::uint32_t) {}                      // (u, parent або npos)
+};
+
+class DepthFirstSearch {
+public:
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+private:
+    struct Frame {
+        std::uint32_t vertex;
+        std::uint32_t nextEdge; // індекс у targets
+    };
+    std::vector<Frame>        stack_;
+    std::vector<std::uint8_t> visited_;
+
+public:
+    // скинути позначки перед новим обходом графа з n вершинами
+    void reset(std::size_t n) { visited_.assign(n, 0); stack_.clear(); }
+    bool visited(std::uint32_t u) const { return visited_[u] != 0; }
+
+    // (М47) G — будь-який CSR з полями offsets/targets (DenseGraph, UndirectedCsr)
+    template <typename G, typename Visitor>
+    void visit(const G& g, std::uint32_t root, Visitor& vis) {
+        if (visited_[root]) return;
+        visited_[root] = 1;
+        vis.discover(root);
+        stack_.push_back({root, g.offsets[root]});
+
+        while (!stack_.empty()) {
+            Frame& top = stack_.back();
+            const std::uint32_t u = top.vertex;
+            if (top.nextEdge < g.offsets[u + 1]) {
+                const std::uint32_t e = top.nextEdge++;
+                const std::uint32_t v = g.targets[e];
+                if (!visited_[v]) {
+                    visited_[v] = 1;
+                    vis.treeEdge(u, v, e);
+                    vis.discover(v);
+                    stack_.push_back({v, g.offsets[v]}); // top після цього недійсний
+                } else {
+                    vis.nonTreeEdge(u, v, e);
+                }
+            } else {
+                stack_.pop_back();
+                vis.finish(u, stack_.empty() ? npos : stack_.back().vertex);
+            }
+        }
+    }
+
+    // (М48) ліс DFS: корені — у порядку ID
+    template <typename G, typename Visitor>
+    void run(const G& g, Visitor& vis) {
+        const std::size_t n = g.offsets.size() - 1;
+        reset(n);
+        for (std::uint32_t r = 0; r < n; ++r) visit(g, r, vis);
+    }
+};
+
+struct UndirectedCsr {
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> targets;
+    std::vector<std::uint32_t> edgeIds;      // ID неорієнтованого ребра для кожного запису targets
+    std::vector<std::uint32_t> multiplicity; // ID ребра -> кількість незалежних зв'язків {u, v}
+    std::size_t edgeCount = 0;               // кількість неорієнтованих ребер
+
+    // (М49) {u, v} — одне ребро незалежно від напряму; кратність = max(#u->v, #v->u): кожен Link
+    // дає не більше однієї дуги в кожному напрямі, тож дві дуги u->v — це два різні канали
+    template <typename TNode>
+    static UndirectedCsr fromDirected(const DenseGraph<TNode>& g) {
+        const std::size_t n = g.size();
+        std::vector<std::tuple<std::uint32_t, std::uint32_t, bool>> arcs; // (min, max, u < v)
+        arcs.reserve(g.edgeCount());
+        for (std::uint32_t u = 0; u < n; ++u) {
+            for (std::uint32_t e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+                const std::uint32_t v = g.targets[e];
+                if (u != v) arcs.push_back({std::min(u, v), std::max(u, v), u < v});
+            }
+        }
+        std::sort(arcs.begin(), arcs.end());
+
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+        UndirectedCsr c;
+        for (std::size_t i = 0; i < arcs.size();) {
+            const std::uint32_t a = std::get<0>(arcs[i]), b = std::get<1>(arcs[i]);
+            std::uint32_t forward = 0, backward = 0;
+            for (; i < arcs.size() && std::get<0>(arcs[i]) == a && std::get<1>(arcs[i]) == b; ++i)
+                ++(std::get<2>(arcs[i]) ? forward : backward);
+            pairs.push_back({a, b});
+            c.multiplicity.push_back(std::max(forward, backward));
+        }
+
+        c.edgeCount = pairs.size();
+        c.offsets.assign(n + 1, 0);
+        for (auto& [a, b] : pairs) { ++c.offsets[a + 1]; ++c.offsets[b + 1]; }
+        for (std::size_t i = 0; i < n; ++i) c.offsets[i + 1] += c.offsets[i];
+        c.targets.resize(2 * pairs.size());
+        c.edgeIds.resize(2 * pairs.size());
+        std::vector<std::uint32_t> cursor(c.offsets.begin(), c.offsets.end() - 1);
+        for (std::uint32_t id = 0; id < pairs.size(); ++id) {
+            auto [a, b] = pairs[id];
+            c.targets[cursor[a]] = b; c.edgeIds[cursor[a]++] = id;
+            c.targets[cursor[b]] = a; c.edgeIds[cursor[b]++] = id;
+        }
+        return c;
+    }
+};
+
+struct SccResult {
+    std::vector<std::uint32_t> component; // ID вершини -> номер компоненти
+    std::uint32_t count = 0;
+};
+
+// (М50) Тар'ян: low-link оновлюється в nonTreeEdge (вершини на стеку) і при finish нащадка
+template <typename TNode>
+SccResult stronglyConnectedComponents(const DenseGraph<TNode>& g) {
+    struct TarjanVisitor : DfsVisitor {
+        std::vector<std::uint32_t> index, low, stack;
+        std::vector<std::uint8_t>  onStack;
+        SccResult                  result;
+        std::uint32_t              counter = 0;
+
+        explicit TarjanVisitor(std::size_t n)
+            : index(n), low(n), onStack(n, 0) { result.component.assign(n, 0); }
+
+        void discover(std::uint32_t u) {
+            index[u] = low[u] = counter++;
+            stack.push_back(u);
+            onStack[u] = 1;
+        }
+        void nonTreeEdge(std::uint32_t u, std::uint32_t v, std::uint32_t) {
+            if (onStack[v]) low[u] = std::min(low[u], index[v]);
+        }
+        void finish(std::uint32_t u, std::uint32_t parent) {
+            if (low[u] == index[u]) { // u — корінь компоненти
+                std::uint32_t w;
+                do {
+                    w = stack.back(); stack.pop_back();
+                    onStack[w] = 0;
+                    result.component[w] = result.count;
+                } while (w != u);
+                ++result.count;
+            }
+            if (parent != DepthFirstSearch::npos) low[parent] = std::min(low[parent], low[u]);
+        }
+    };
+
+    TarjanVisitor vis(g.size());
+    DepthFirstSearch dfs;
+    dfs.run(g, vis);
+    return std::move(vis.result);
+}
+
+// low-link на неорієнтованому графі: спільна частина для точок зчленування і мостів
+struct LowLinkVisitor : DfsVisitor {
+    const UndirectedCsr&       g;
+    std::vector<std::uint32_t> disc, low, parentEdge, children;
+    std::vector<std::uint8_t>  isArticulation;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> bridges;
+    std::uint32_t              counter = 0;
+
+    explicit LowLinkVisitor(const UndirectedCsr& csr)
+        : g(csr), disc(csr.offsets.size() - 1), low(csr.offsets.size() - 1),
+          parentEdge(csr.offsets.size() - 1, DepthFirstSearch::npos),
+          children(csr.offsets.size() - 1, 0), isArticulation(csr.offsets.size() - 1, 0) {}
+
+    void discover(std::uint32_t u) { disc[u] = low[u] = counter++; }
+    void treeEdge(std::uint32_t u, std::uint32_t v, std::uint32_t e) {
+        parentEdge[v] = g.edgeIds[e];
+        ++children[u];
+    }
+    void nonTreeEdge(std::uint32_t u, std::uint32_t v, std::uint32_t e) {
+        if (g.edgeIds[e] != parentEdge[u]) low[u] = std::min(low[u], disc[v]);
+    }
+    void finish(std::uint32_t u, std::uint32_t parent) {
+        if (parent == DepthFirstSearch::npos) { // корінь дерева DFS
+            if (children[u] >= 2) isArticulation[u] = 1;
+            return;
+        }
+        low[parent] = std::min(low[parent], low[u]);
+        // кратне ребро не є мостом: відмова одного каналу залишає інший
+        if (low[u] > disc[parent] && g.multiplicity[parentEdge[u]] < 2) bridges.push_back({parent, u});
+        if (low[u] >= disc[parent] && parentEdge[parent] != DepthFirstSearch::npos)
+            isArticulation[parent] = 1;
+    }
+};
+
+inline LowLinkVisitor runLowLink(const UndirectedCsr& csr) {
+    LowLinkVisitor vis(csr);
+    DepthFirstSearch dfs;
+    dfs.run(csr, vis);
+    return vis;
+}
+
+// (М51) ID точок зчленування (за зростанням)
+inline std::vector<std::uint32_t> articulationPoints(const UndirectedCsr& csr) {
+    auto vis = runLowLink(csr);
+    std::vector<std::uint32_t> result;
+    for (std::uint32_t u = 0; u < vis.isArticulation.size(); ++u)
+        if (vis.isArticulation[u]) result.push_back(u);
+    return result;
+}
+
+// (М52) мости як пари ID (менший, більший), відсортовані
+inline std::vector<std::pair<std::uint32_t, std::uint32_t>> bridges(const UndirectedCsr& csr) {
+    auto vis = runLowLink(csr);
+    for (auto& [a, b] : vis.bridges) if (a > b) std::swap(a, b);
+    std::sort(vis.bridges.begin(), vis.bridges.end());
+    return std::move(vis.bridges);
+}
+
+// --- обгортки над Graph<TNode, TEdge> ---
+
+template <typename TNode, typename TEdge>
+std::vector<std::vector<TNode>> stronglyConnectedComponents(const Graph<TNode, TEdge>& g) {
+    DenseGraph<TNode> d = DenseGraph<TNode>::fromGraph(g);
+    SccResult scc = stronglyConnectedComponents(d);
+    std::vector<std::vector<TNode>> result(scc.count);
+    for (std::uint32_t u = 0; u < d.size(); ++u) result[scc.component[u]].push_back(d.nodes[u]);
+    return result;
+}
+
+template <typename TNode, typename TEdge>
+std::vector<TNode> articulationPoints(const Graph<TNode, TEdge>& g) {
+    DenseGraph<TNode> d = DenseGraph<TNode>::fromGraph(g);
+    std::vector<TNode> result;
+    for (std::uint32_t u : articulationPoints(UndirectedCsr::fromDirected(d))) result.push_back(d.nodes[u]);
+    return result;
+}
+
+template <typename TNode, typename TEdge>
+std::vector<std::pair<TNode, TNode>> bridges(const Graph<TNode, TEdge>& g) {
+    DenseGraph<TNode> d = DenseGraph<TNode>::fromGraph(g);
+    std::vector<std::pair<TNode, TNode>> result;
+    for (auto [a, b] : bridges(UndirectedCsr::fromDirected(d))) result.push_back({d.nodes[a], d.nodes[b]});
+    return result;
+}
+
+#endif //GRAPHCONNECTIVITY_H
@@ -0,0 +1,283 @@
+#ifndef GRAPHPARTITIONER_H
+#define GRAPHPARTITIONER_H
+
+/*
+КЛАСИ/ТИПИ У ФАЙЛІ:
+ 33) struct WeightedCsr - неорієнтований граф з вагами вершин і ребер (рівень багаторівневої схеми)
+ 34) struct PartitionResult - номер частини для кожної вершини + розріз і ваги частин
+ 35) class GraphPartitioner - багаторівневе розбиття на k збалансованих частин (METIS-подібне)
+
+ПОЛЯ:
+  - WeightedCsr: offsets, targets, edgeWeights, vertexWeights - 4
+  - PartitionResult: part, partWeights, edgeCut, parts - 4
+  - GraphPartitioner: parts_, imbalance_, seed_ - 3
+  разом: 11
+
+НЕТРИВІАЛЬНІ МЕТОДИ:
+  (М54) WeightedCsr::fromUndirected(g) - рівень 0: усі ваги = 1
+  (М55) GraphPartitioner::coarsen(...) - heavy-edge matching + стягування пар вершин
+  (М56) GraphPartitioner::initialPartition(...) - нарощування k областей (BFS) на найгрубшому рівні
+  (М57) GraphPartitioner::refine(...) - жадібне k-way покращення межі (FM-подібне) з обмеженням ваги
+  (М58) GraphPartitioner::partition(g) - стягування -> початкове розбиття -> проєкція + покращення
+  разом: 5
+
+ПРИМІТКИ:
+  - класична багаторівнева схема: граф стягується (кожна вершина об'єднується із сусідом по
+    найважчому ребру), поки не стане малим; там будується початкове розбиття, яке потім
+    проєктується назад і на кожному рівні покращується переміщенням граничних вершин;
+  - баланс: вага кожної частини <= (1 + imbalance) * W / k (якщо це досяжно з такими вагами вершин);
+  - результат детермінований для заданого seed (власний Fisher-Yates поверх std::mt19937).
+*/
+
+#include "GraphConnectivity.h" // UndirectedCsr
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+struct WeightedCsr {
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> targets;
+    std::vector<std::uint32_t> edgeWeights;
+    std::vector<std::uint32_t> vertexWeights;
+
+    std::size_t size() const { return vertexWeights.size(); }
+
+    // (М54)
+    static WeightedCsr fromUndirected(const UndirectedCsr& g) {
+        WeightedCsr w;
+        w.offsets = g.offsets;
+        w.targets = g.targets;
+        w.edgeWeights.assign(g.targets.size(), 1);
+        w.vertexWeights.assign(g.offsets.size() - 1, 1);
+        return w;
+    }
+};
+
+struct PartitionResult {
+    std::vector<std::uint32_t> part;        // ID вершини -> номер частини
+    std::vector<std::uint64_t> partWeights; // сумарна вага вершин кожної частини
+    std::uint64_t edgeCut = 0;              // сумарна вага ребер між частинами
+    std::uint32_t parts = 0;
+};
+
+class GraphPartitioner {
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    std::uint32_t parts_;
+    double        imbalance_;
+    std::uint32_t seed_;
+
+    static std::uint64_t totalWeight(const WeightedCsr& g) {
+        std::uint64_t t = 0;
+        for (auto w : g.vertexWeights) t += w;
+        return t;
+    }
+
+    // (М55) повертає грубший граф; cmap[u] — його вершина, що містить u
+    static WeightedCsr coarsen(const WeightedCsr& g, std::uint32_t maxVertexWeight,
+                               std::mt19937& rng, std::vector<std::uint32_t>& cmap)
+    {
+        const std::size_t n = g.size();
+        std::vector<std::uint32_t> order(n);
+        for (std::uint32_t i = 0; i < n; ++i) order[i] = i;
+        for (std::size_t i = n; i > 1; --i) std::swap(order[i - 1], order[rng() % i]);
+
+        std::vector<std::uint32_t> match(n, npos);
+        for (std::uint32_t u : order) {
+            if (match[u] != npos) continue;
+            std::uint32_t best = u, bestWeight = 0;
+            for (std::uint32_t e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+                const std::uint32_t v = g.targets[e];
+                if (match[v] != npos || v == u) continue;
+                if (g.vertexWeights[u] + g.vertexWeights[v] > maxVertexWeight) continue;
+                if (g.edgeWeights[e] > bestWeight) { best = v; bestWeight = g.edgeWeights[e]; }
+            }
+            match[u] = best;
+            match[best] = u;
+        }
+
+        // грубі ID — у порядку меншої вершини пари
+        cmap.assign(n, npos);
+        std::vector<std::uint32_t> first;
+        for (std::uint32_t u = 0; u < n; ++u) {
+            if (cmap[u] != npos) continue;
+            cmap[u] = cmap[match[u]] = static_cast<std::uint32_t>(first.size());
+            first.push_back(u);
+        }
+
+        const std::size_t nc = first.size();
+        WeightedCsr c;
+        c.offsets.reserve(nc + 1);
+        c.offsets.push_back(0);
+        c.vertexWeights.resize(nc);
+        std::vector<std::uint32_t> slot(nc, npos); // грубий сусід -> позиція в поточному списку
+        for (std::uint32_t cu = 0; cu < nc; ++cu) {
+            const std::uint32_t members[2] = {first[cu], match[first[cu]]};
+            const std::size_t count = members[0] == members[1] ? 1 : 2;
+            const std::size_t rowStart = c.targets.size();
+            std::uint32_t weight = 0;
+            for (std::size_t m = 0; m < count; ++m) {
+                const std::uint32_t u = members[m];
+                weight += g.vertexWeights[u];
+                for (std::uint32_t e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+                    const std::uint32_t cv = cmap[g.targets[e]];
+                    if (cv == cu) continue; // ребро всередині пари зникає
+                    if (slot[cv] == npos) {
+                        slot[cv] = static_cast<std::uint32_t>(c.targets.size());
+                        c.targets.push_back(cv);
+                        c.edgeWeights.push_back(0);
+                    }
+                    c.edgeWeights[slot[cv]] += g.edgeWeights[e];
+                }
+            }
+            for (std::size_t i = rowStart; i < c.targets.size(); ++i) slot[c.targets[i]] = npos;
+            c.vertexWeights[cu] = weight;
+            c.offsets.push_back(static_cast<std::uint32_t>(c.targets.size()));
+        }
+        return c;
+    }
+
+    // (М56) частини 0..k-2 нарощуються BFS до цільової ваги, решта — в останню
+    static std::vector<std::uint32_t> initialPartition(const WeightedCsr& g, std::uint32_t k) {
+        const std::size_t n = g.size();
+        const std::uint64_t target = totalWeight(g) / k;
+        std::vector<std::uint32_t> part(n, npos);
+        std::uint32_t nextSeed = 0;
+
+        for (std::uint32_t p = 0; p + 1 < k; ++p) {
+            std::uint64_t weight = 0;
+            std::queue<std::uint32_t> frontier;
+            while (weight < target) {
+                if (frontier.empty()) { // нова область або незв'язна компонента
+                    while (nextSeed < n && part[nextSeed] != npos) ++nextSeed;
+                    if (nextSeed == n) break;
+                    frontier.push(nextSeed);
+                }
+                const std::uint32_t u = frontier.front(); frontier.pop();
+                if (part[u] != npos) continue;
+                part[u] = p;
+                weight += g.vertexWeights[u];
+                for (std::uint32_t e = g.offsets[u]; e < g.offsets[u + 1]; ++e)
+                    if (part[g.targets[e]] == npos) frontier.push(g.targets[e]);
+            }
+        }
+        for (auto& p : part) if (p == npos) p = k - 1;
+        return part;
+    }
+
+    // (М57) переносимо граничну вершину в сусідню частину, якщо це зменшує розріз
+    // (або за рівного розрізу покращує баланс, або звільняє перевантажену частину)
+    static void refine(const WeightedCsr& g, std::vector<std::uint32_t>& part,
+                       std::uint32_t k, std::uint64_t maxWeight, int passes)
+    {
+        const std::size_t n = g.size();
+        std::vector<std::uint64_t> partWeight(k, 0);
+        for (std::uint32_t u = 0; u < n; ++u) partWeight[part[u]] += g.vertexWeights[u];
+
+        std::vector<std::int64_t> conn(k, 0);
+        std::vector<std::uint32_t> touched;
+        for (int pass = 0; pass < passes; ++pass) {
+            std::size_t moved = 0;
+            for (std::uint32_t u = 0; u < n; ++u) {
+                const std::uint32_t a = part[u];
+                const std::uint64_t wu = g.vertexWeights[u];
+                touched.clear();
+                for (std::uint32_t e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+                    const std::uint32_t p = part[g.targets[e]];
+                    if (conn[p] == 0) touched.push_back(p);
+                    conn[p] += g.edgeWeights[e];
+                }
+                const bool overloaded = partWeight[a] > maxWeight;
+                std::uint32_t best = a;
+                std::int64_t bestGain = std::numeric_limits<std::int64_t>::min();
+                for (std::uint32_t p : touched) {
+                    if (p == a || partWeight[p] + wu > maxWeight) continue;
+                    const std::int64_t gain = conn[p] - conn[a];
+                    const bool accept = gain > 0 || overloaded
+                        || (gain == 0 && partWeight[p] + wu < partWeight[a]);
+                    if (accept && gain > bestGain) { best = p; bestGain = gain; }
+                }
+                for (std::uint32_t p : touched) conn[p] = 0;
+                if (best != a) {
+                    partWeight[a] -= wu;
+                    partWeight[best] += wu;
+                    part[u] = best;
+                    ++moved;
+                }
+            }
+            if (moved == 0) break;
+        }
+    }
+
+public:
+    explicit GraphPartitioner(std::uint32_t parts, double imbalance = 0.03, std::uint32_t seed = 1)
+        : parts_(parts), imbalance_(imbalance), seed_(seed)
+    {
+        if (parts_ == 0) throw std::runtime_error("GraphPartitioner: parts must be > 0");
+    }
+
+    // (М58)
+    PartitionResult partition(const UndirectedCsr& input) const {
+        PartitionResult result;
+        result.parts = parts_;
+        const std::size_t n = input.offsets.size() - 1;
+        result.part.assign(n, 0);
+        result.partWeights.assign(parts_, 0);
+        if (n == 0) return result;
+
+        std::vector<WeightedCsr> levels;
+        std::vector<std::vector<std::uint32_t>> maps;
+        levels.push_back(WeightedCsr::fromUndirected(input));
+
+        const std::uint64_t total = n;
+        const std::uint64_t maxWeight = static_cast<std::uint64_t>(
+            std::ceil((1.0 + imbalance_) * static_cast<double>(total) / parts_));
+
+        if (parts_ > 1) {
+            // стягуємо до ~20 вершин на частину; важкі грубі вершини заважали б балансу
+            const std::size_t coarsenTo = std::max<std::size_t>(20u * parts_, 64u);
+            const auto maxVertexWeight = static_cast<std::uint32_t>(
+                std::max<std::uint64_t>(1, (3 * total) / (2 * coarsenTo)));
+            std::mt19937 rng(seed_);
+            while (levels.back().size() > coarsenTo) {
+                std::vector<std::uint32_t> cmap;
+                WeightedCsr coarse = coarsen(levels.back(), maxVertexWeight, rng, cmap);
+                if (coarse.size() * 20 > levels.back().size() * 19) break; // стягування зупинилось
+                levels.push_back(std::move(coarse));
+                maps.push_back(std::move(cmap));
+            }
+
+            std::vector<std::uint32_t> part = initialPartition(levels.back(), parts_);
+            refine(levels.back(), part, parts_, maxWeight, 8);
+            for (std::size_t lvl = maps.size(); lvl-- > 0; ) {
+                std::vector<std::uint32_t> finer(levels[lvl].size());
+                for (std::uint32_t u = 0; u < finer.size(); ++u) finer[u] = part[maps[lvl][u]];
+                part = std::move(finer);
+                refine(levels[lvl], part, parts_, maxWeight, 8);
+            }
+            result.part = std::move(part);
+        }
+
+        const WeightedCsr& g = levels.front();
+        for (std::uint32_t u = 0; u < n; ++u) {
+            result.partWeights[result.part[u]] += g.vertexWeights[u];
+            for (std::uint32_t e = g.offsets[u]; e < g.offsets[u + 1]; ++e)
+                if (u < g.targets[e] && result.part[u] != result.part[g.targets[e]])
+                    result.edgeCut += g.edgeWeights[e];
+        }
+        return result;
+    }
+
+    // розбиття Graph<TNode, TEdge>: part[i] відповідає DenseGraph<TNode>::fromGraph(g).nodes[i]
+    template <typename TNode, typename TEdge>
+    PartitionResult partition(const Graph<TNode, TEdge>& g) const {
+        return partition(UndirectedCsr::fromDirected(DenseGraph<TNode>::fromGraph(g)));
+    }
+};
+
+#endif //GRAPHPARTITIONER_H
@@ -0,0 +1,207 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+/*
+КЛАСИ/ТИПИ У ФАЙЛІ:
+ 16) enum class Metric - перелік лічильників/таймерів гарячих шляхів
+ 17) struct MetricsSnapshot - зведені значення + експорт у JSON / Prometheus
+ 18) class MetricsRegistry - реєстр потокових буферів (глобальний, один на процес)
+ 19) class MetricsTimer - RAII-таймер, додає тривалість області видимості до лічильника
+
+ПОЛЯ:
+  - MetricsSnapshot: values - 1
+  - MetricsRegistry: mutex_, live_, retired_, baseline_ - 4
+  - MetricsTimer: metric_, start_ - 2
+  разом: 7
+
+НЕТРИВІАЛЬНІ МЕТОДИ:
+  (М33) MetricsSnapshot::toJson() - серіалізація у JSON-об'єкт
+  (М34) MetricsSnapshot::toPrometheus() - серіалізація у текстовий формат Prometheus
+  (М35) MetricsRegistry::snapshot() - сума по всіх потоках (живих і завершених)
+  (М36) MetricsRegistry::reset() - запам'ятовує базову лінію, від якої рахується snapshot
+  (М37) metricAdd(metric, n) - збільшення лічильника у буфері поточного потоку
+  разом: 5
+
+ПРИМІТКИ:
+  - збирання вмикається на етапі компіляції макросом NETSIM_METRICS
+    (у CMake: -DNETSIM_METRICS=ON). Без нього макроси NETSIM_METRIC_ADD / NETSIM_METRIC_TIMER
+    розгортаються у ((void)0): аргументи не обчислюються, код не генерується.
+  - кожен потік пише лише у власний буфер (thread_local), тому гарячий шлях не має
+    спільних кеш-ліній і атомарних read-modify-write; snapshot() лише читає буфери.
+  - MetricsRegistry/MetricsSnapshot доступні завжди — при вимкненому збиранні snapshot() повертає нулі.
+*/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef NETSIM_METRICS
+inline constexpr bool kMetricsEnabled = true;
+#else
+inline constexpr bool kMetricsEnabled = false;
+#endif
+
+// лічильники гарячих шляхів (час — у наносекундах)
+enum class Metric : std::size_t {
+    VerticesSettled,      // Dijkstra: вершини, зняті з купи з актуальною відстанню
+    EdgesRelaxed,         // Dijkstra: перевірені ребра (спроби релаксації)
+    HeapPushes,           // Dijkstra: вставки у мін-купу
+    StalePops,            // Dijkstra: застарілі елементи, зняті з купи
+    WeightedGraphBuildNs, // DijkstraRouting: побудова тимчасового графа WeightedEdge
+    HopsSimulated,        // sendPacket: кількість пройдених хопів
+    HopCostNs,            // sendPacket: пошук Link і обчислення вартості хопа
+    BytesParsed,          // loadTopology: прочитані байти файлу
+    TopologyLoadNs,       // loadTopology: повний час завантаження
+    Count
+};
+
+inline constexpr std::size_t kMetricCount = static_cast<std::size_t>(Metric::Count);
+
+// імена для експорту (порядок збігається з enum Metric)
+inline constexpr std::array<const char*, kMetricCount> kMetricNames = {
+    "dijkstra_vertices_settled_total",
+    "dijkstra_edges_relaxed_total",
+    "dijkstra_heap_pushes_total",
+    "dijkstra_stale_pops_total",
+    "routing_weighted_graph_build_ns_total",
+    "simulator_hops_total",
+    "simulator_hop_cost_ns_total",
+    "topology_bytes_parsed_total",
+    "topology_load_ns_total",
+};
+
+// знімок значень на момент виклику MetricsRegistry::snapshot()
+struct MetricsSnapshot {
+    std::array<std::uint64_t, kMetricCount> values{};
+
+    std::uint64_t operator[](Metric m) const { return values[static_cast<std::size_t>(m)]; }
+
+    // (М33) {"dijkstra_vertices_settled_total": 3, ...}
+    std::string toJson() const {
+        std::ostringstream out;
+        out << "{";
+        for (std::size_t i = 0; i < kMetricCount; ++i) {
+            out << (i ? ", " : "") << "\"" << kMetricNames[i] << "\": " << values[i];
+        }
+        out << "}";
+        return out.str();
+    }
+
+    // (М34) текстовий формат Prometheus: # TYPE ... counter + рядок зі значенням
+    std::string toPrometheus(const std::string& prefix = "netsim_") const {
+        std::ostringstream out;
+        for (std::size_t i = 0; i < kMetricCount; ++i) {
+            out << "# TYPE " << prefix << kMetricNames[i] << " counter\n"
+                << prefix << kMetricNames[i] << " " << values[i] << "\n";
+        }
+        return out.str();
+    }
+};
+
+// буфер одного потоку; пише лише власник, інші потоки тільки читають
+struct MetricsBuffer {
+    std::array<std::atomic<std::uint64_t>, kMetricCount> values{};
+};
+
+class MetricsRegistry {
+    std::mutex mutex_;
+    std::vector<const MetricsBuffer*> live_;               // буфери активних потоків
+    std::array<std::uint64_t, kMetricCount> retired_{};   // внесок завершених потоків
+    std::array<std::uint64_t, kMetricCount> baseline_{};  // значення на момент reset()
+
+    std::array<std::uint64_t, kMetricCount> totalsUnlocked() const {
+        std::array<std::uint64_t, kMetricCount> sum = retired_;
+        for (const MetricsBuffer* b : live_)
+            for (std::size_t i = 0; i < kMetricCount; ++i)
+                sum[i] += b->values[i].load(std::memory_order_relaxed);
+        return sum;
+    }
+
+public:
+    static MetricsRegistry& instance() {
+        static MetricsRegistry registry;
+        return registry;
+    }
+
+    void attach(const MetricsBuffer* b) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        live_.push_back(b);
+    }
+
+    // потік завершується: переносимо його значення у retired_
+    void detach(const MetricsBuffer* b) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::size_t i = 0; i < kMetricCount; ++i)
+            retired_[i] += b->values[i].load(std::memory_order_relaxed);
+        std::erase(live_, b);
+    }
+
+    // (М35) сума по всіх потоках мінус базова лінія
+    MetricsSnapshot snapshot() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        MetricsSnapshot s;
+        auto sum = totalsUnlocked();
+        for (std::size_t i = 0; i < kMetricCount; ++i) s.values[i] = sum[i] - baseline_[i];
+        return s;
+    }
+
+    // (М36) чужі буфери не перезаписуємо (це була б гонка з потоком-власником)
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        baseline_ = totalsUnlocked();
+    }
+};
+
+// реєструє буфер потоку при першому використанні і знімає з реєстру при завершенні потоку
+class ThreadMetrics {
+    MetricsBuffer buffer_;
+public:
+    ThreadMetrics() { MetricsRegistry::instance().attach(&buffer_); }
+    ~ThreadMetrics() { MetricsRegistry::instance().detach(&buffer_); }
+    ThreadMetrics(const ThreadMetrics&) = delete;
+    ThreadMetrics& operator=(const ThreadMetrics&) = delete;
+
+    MetricsBuffer& buffer() { return buffer_; }
+};
+
+// (М37) load + store замість fetch_add: пише лише потік-власник, тож lock-префікс не потрібен
+inline void metricAdd(Metric m, std::uint64_t n) {
+    thread_local ThreadMetrics local;
+    auto& counter = local.buffer().values[static_cast<std::size_t>(m)];
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+// RAII-таймер: додає тривалість області видимості (нс) до лічильника
+class MetricsTimer {
+    Metric metric_;
+    std::chrono::steady_clock::time_point start_;
+public:
+    explicit MetricsTimer(Metric m) : metric_(m), start_(std::chrono::steady_clock::now()) {}
+    ~MetricsTimer() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_).count();
+        metricAdd(metric_, static_cast<std::uint64_t>(ns));
+    }
+    MetricsTimer(const MetricsTimer&) = delete;
+    MetricsTimer& operator=(const MetricsTimer&) = delete;
+};
+
+#define NETSIM_METRIC_CONCAT_(a, b) a##b
+#define NETSIM_METRIC_CONCAT(a, b) NETSIM_METRIC_CONCAT_(a, b)
+
+#ifdef NETSIM_METRICS
+#define NETSIM_METRIC_ADD(metric, n) metricAdd(Metric::metric, static_cast<std::uint64_t>(n))
+#define NETSIM_METRIC_TIMER(metric) \
+    MetricsTimer NETSIM_METRIC_CONCAT(netsimMetricTimer_, __LINE__)(Metric::metric)
+#else
+#define NETSIM_METRIC_ADD(metric, n) ((void)0)
+#define NETSIM_METRIC_TIMER(metric) ((void)0)
+#endif
+
+#endif //METRICS_H
@@ -6,13 +6,19 @@
  13) class RoutingAlgorithm (абстрактний) [КЛАС №13]
  14) class DijkstraRouting : public RoutingAlgorithm [КЛАС №14]
  15) class NetworkSimulator [КЛАС №15]
+ 32) struct TopologyReport - зв'язність топології та "єдині точки відмови"
+ 46) class NetworkSimulator::TopologyEditor - addDevice/connect всередині update() (над чернеткою)
+ 47) struct TopologyVersion - опублікована версія: граф + кешовані LinkArrays
 
 ПОЛЯ:
   - DijkstraRouting: (немає постійних полів)
+  - TopologyVersion: graph, linksOnce_, links_ - 3
   - NetworkSimulator:
       graph_  (Graph<std::string, Link>) - 1
       devices_(std::map<std::string, Device*>) - 1
-    разом: 2
+      version_ (std::atomic<std::shared_ptr<const TopologyVersion>>) - 1
+      writeMutex_ (std::mutex) - 1
+    разом: 7
 
 НЕТРИВІАЛЬНІ МЕТОДИ:
   (М21) RoutingAlgorithm::route(...) - абстрактний поліморфний метод
@@ -25,9 +31,31 @@
   (М28) NetworkSimulator::saveTopology(...) - збереження у файл
   (М29) NetworkSimulator::loadTopology(...) - читання з файлу
   (М30) NetworkSimulator::printDevices() - друк реєстру пристроїв
-  разом: 10
+  (М31) NetworkSimulator::snapshot() - поточна незмінна версія топології (без writeMutex_)
+  (М32) NetworkSimulator::publish() - атомарна публікація нової версії топології
+  (М40) NetworkSimulator::findRoute<Algo>(...) - статична диспетчеризація, маршрут у буфер викликача
+  (М46) NetworkSimulator::findRoutes(...) - маршрути для набору розмірів пакета за один прохід
+  (М53) NetworkSimulator::analyzeTopology() - SCC, точки зчленування і мости поточної топології
+  (М65) NetworkSimulator::shard(k) - шардова симуляція поточної топології (k процесів, лише POSIX)
+  (М71) NetworkSimulator::update(mutate) - пакетна зміна топології з однією публікацією
+  (М72) TopologyVersion::linkArrays() - SoA-подання версії, будується один раз (call_once)
+  (М73) NetworkSimulator::linkArrays() - LinkArrays поточної версії (для findRoutes, аналізу, трас)
+  разом: 19
 
 ПРИМІТКА:
+  - багатопотоковість (copy-on-write, RCU-подібно): читачі (findRoute, sendPacket) беруть
+    знімок (version_) без writeMutex_ і працюють з незмінним графом; писачі (addDevice, connect,
+    loadTopology) змінюють робочу копію graph_ під writeMutex_ і публікують нову версію
+    одним атомарним store. Старі версії живуть, доки ними користується хоча б один читач.
+  - читання НЕ lock-free: std::atomic<std::shared_ptr> у libstdc++ (GCC 12) має is_lock_free()
+    == false — load() коротко тримає спін-замок у біті самого атомарного слова і збільшує
+    спільний лічильник посилань версії. Тож читачі не чекають на писача, що копіює граф (той
+    тримає спін-замок лише на час store), але всі вони змагаються за одну кеш-лінію; при дуже
+    частих snapshot() з багатьох потоків краще брати знімок раз на пакет запитів.
+  - кожна публікація копіює весь граф, тому велику топологію слід будувати через update():
+    N викликів addDevice/connect коштують O(N·(V+E)), один update() — O(V+E).
+  - LinkArrays (SoA для findRoutes/analyzeTopology/трас) живуть у тій самій TopologyVersion,
+    що й граф: будуються за першим запитом до версії і далі лише перевикористовуються.
   - друга ієрархія успадкування: RoutingAlgorithm → DijkstraRouting (динамічний поліморфізм)
   - перша ієрархія — у Network.hpp: Device → Router/Switch/Host
 */
@@ -35,10 +63,18 @@
 #include "Graph.h"
 #include "GraphAlgorithms.h" // Dijkstra + WeightedEdge
 #include "Network.h"
+#include "Metrics.h"
+#include "StaticRouting.h" // StaticDijkstraRouting + concept StaticRoutingAlgorithm
+#include "PayloadSweep.h"  // LinkArrays + PayloadSweepRouting
+#include "GraphConnectivity.h" // SCC, точки зчленування, мости
+#include "ShardedSimulation.h" // GraphPartitioner + ShardedSimulator (лише POSIX)
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
 #include <iomanip>
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 
 // інтерфейс алгоритму маршрутизації
@@ -65,12 +101,15 @@ public:
     {
         // будуємо тимчасовий граф з WeightedEdge
         Graph<std::string, WeightedEdge> wg(true);
-        for (auto& [u, _] : g.data()) wg.addNode(u);
+        {
+            NETSIM_METRIC_TIMER(WeightedGraphBuildNs);
+            for (auto& [u, _] : g.data()) wg.addNode(u);
 
-        for (auto& [u, vec] : g.data()) {
-            for (auto& [v, link] : vec) {
-                double w = link.costForBytes(payloadBytes); // час у секундах
-                wg.addEdge(u, v, WeightedEdge{ w });
+            for (auto& [u, vec] : g.data()) {
+                for (auto& [v, link] : vec) {
+                    double w = link.costForBytes(payloadBytes); // час у секундах
+                    wg.addEdge(u, v, WeightedEdge{ w });
+                }
             }
         }
 
@@ -80,13 +119,69 @@ public:
     }
 };
 
+// результат analyzeTopology(): що ламає зв'язність при відмові одного вузла/каналу
+struct TopologyReport {
+    std::size_t stronglyConnectedComponents = 0;               // 1 — кожен вузол досяжний з кожного
+    std::vector<std::string> articulationPoints;               // вузли — єдині точки відмови
+    std::vector<std::pair<std::string, std::string>> bridges;  // канали — єдині точки відмови
+};
+
+// незмінна версія топології, яку читачі утримують, поки з нею працюють
+using TopologySnapshot = std::shared_ptr<const Graph<std::string, Link>>;
+
+// опублікована версія: граф + його SoA-подання, побудоване один раз на версію (за першим запитом)
+struct TopologyVersion {
+    Graph<std::string, Link> graph;
+
+    explicit TopologyVersion(Graph<std::string, Link> g = Graph<std::string, Link>()) : graph(std::move(g)) {}
+
+    // (М72) LinkArrays цієї версії; паралельні перші виклики будують масиви лише раз
+    const LinkArrays& linkArrays() const {
+        std::call_once(linksOnce_, [this] { links_ = LinkArrays::fromGraph(graph); });
+        return links_;
+    }
+
+private:
+    mutable std::once_flag linksOnce_;
+    mutable LinkArrays     links_;
+};
+
 // симулятор мережі
 class NetworkSimulator {
 private:
-    Graph<std::string, Link>      graph_;
-    std::map<std::string, Device*> devices_;
+    Graph<std::string, Link>      graph_;   // робоча копія писача (лише під writeMutex_)
+    std::map<std::string, Device*> devices_; // лише під writeMutex_
+    std::atomic<std::shared_ptr<const TopologyVersion>> version_{std::make_shared<const TopologyVersion>()};
+    mutable std::mutex            writeMutex_; // серіалізує писачів між собою; читачі його не беруть
+
+    // (М32) опублікувати копію graph_ як нову версію (викликати під writeMutex_)
+    void publish() {
+        version_.store(std::make_shared<const TopologyVersion>(graph_), std::memory_order_release);
+    }
+
+    std::shared_ptr<const TopologyVersion> version() const {
+        return version_.load(std::memory_order_acquire);
+    }
+
+    // додавання без блокування/публікації (addDevice/connect)
+    void addDeviceUnlocked(Device* d) {
+        if (!d) throw std::runtime_error("Null device");
+        devices_[d->name()] = d;
+        graph_.addNode(d->name());
+    }
+
+    void connectUnlocked(const std::string& a, const std::string& b, const Link& link, bool bidir) {
+        if (!graph_.hasNode(a) || !graph_.hasNode(b))
+            throw std::runtime_error("Unknown node in connect()");
+        graph_.addEdge(a, b, link);
+        if (bidir) graph_.addEdge(b, a, link);
+    }
 
 public:
+    NetworkSimulator() = default;
+    NetworkSimulator(const NetworkSimulator&) = delete;
+    NetworkSimulator& operator=(const NetworkSimulator&) = delete;
+
     ~NetworkSimulator() {
         // прибирання динамічно створених пристроїв (демо-спосіб)
         for (auto& [k, ptr] : devices_) delete ptr;
@@ -94,29 +189,94 @@ public:
 
     // (М23) реєстрація пристрою в мережі
     void addDevice(Device* d) {
-        if (!d) throw std::runtime_error("Null device");
-        devices_[d->name()] = d;
-        graph_.addNode(d->name());
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        addDeviceUnlocked(d);
+        publish();
     }
 
     // (М24) з’єднання двох вузлів каналом Link (за замовч. — двосторонній)
     void connect(const std::string& a, const std::string& b, const Link& link, bool bidir = true) {
-        if (!graph_.hasNode(a) || !graph_.hasNode(b))
-            throw std::runtime_error("Unknown node in connect()");
-        graph_.addEdge(a, b, link);
-        if (bidir) graph_.addEdge(b, a, link);
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        connectUnlocked(a, b, link, bidir);
+        publish();
+    }
+
+    // зміни всередині update(): пишуться в чернетку (копія графа + нові пристрої), а не в graph_
+    class TopologyEditor {
+    private:
+        Graph<std::string, Link>&       graph_;
+        std::map<std::string, Device*>& added_; // нові пристрої пакета; належать пакету до успіху
+        TopologyEditor(Graph<std::string, Link>& graph, std::map<std::string, Device*>& added)
+            : graph_(graph), added_(added) {}
+        friend class NetworkSimulator;
+
+    public:
+        void addDevice(Device* d) {
+            if (!d) throw std::runtime_error("Null device");
+            Device*& slot = added_[d->name()];
+            if (slot != d) delete slot; // повторне ім'я в пакеті: лишається останній пристрій
+            slot = d;
+            graph_.addNode(d->name());
+        }
+        void connect(const std::string& a, const std::string& b, const Link& link, bool bidir = true) {
+            if (!graph_.hasNode(a) || !graph_.hasNode(b))
+                throw std::runtime_error("Unknown node in connect()");
+            graph_.addEdge(a, b, link);
+            if (bidir) graph_.addEdge(b, a, link);
+        }
+    };
+
+    /* (М71) пакетна зміна топології: mutate(TopologyEditor&) виконується під writeMutex_ над
+       копією graph_, а читачам публікується одна версія на весь пакет (а не копія графа на
+       кожне ребро). Все або нічого: якщо mutate кидає виняток, graph_/devices_ не змінюються,
+       нові пристрої пакета видаляються, нічого не публікується, і виняток іде далі. */
+    template <class F>
+    void update(F&& mutate) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        Graph<std::string, Link> draft = graph_;
+        std::map<std::string, Device*> added;
+        try {
+            TopologyEditor editor(draft, added);
+            std::forward<F>(mutate)(editor);
+        } catch (...) {
+            for (auto& [name, ptr] : added) delete ptr;
+            throw;
+        }
+
+        for (auto& [name, ptr] : added) {
+            Device*& slot = devices_[name];
+            if (slot != ptr) delete slot; // пристрій з тим самим ім'ям замінено
+            slot = ptr;
+        }
+        graph_ = std::move(draft);
+        publish();
+    }
+
+    // (М31) поточна версія топології; безпечно викликати з будь-якого потоку
+    // (load не lock-free: короткий спін-замок атомарного shared_ptr + інкремент спільного лічильника)
+    TopologySnapshot snapshot() const {
+        std::shared_ptr<const TopologyVersion> v = version();
+        return TopologySnapshot(v, &v->graph); // аліас: утримує всю версію
+    }
+
+    // (М73) SoA-подання поточної версії; будується раз на опубліковану версію, а не на кожен запит
+    std::shared_ptr<const LinkArrays> linkArrays() const {
+        std::shared_ptr<const TopologyVersion> v = version();
+        return std::shared_ptr<const LinkArrays>(v, &v->linkArrays());
     }
 
     // (М25) демо-топологія:  R1 ─ S1 ─ H1,  R1 ─ H2 (довший шлях)
     void buildDemo() {
-        addDevice(new Router(1, "R1", "eth0"));
-        addDevice(new Switch(2, "S1", "mgmt0"));
-        addDevice(new Host(3, "H1", "10.0.0.1"));
-        addDevice(new Host(4, "H2", "10.0.0.2"));
+        update([](TopologyEditor& t) {
+            t.addDevice(new Router(1, "R1", "eth0"));
+            t.addDevice(new Switch(2, "S1", "mgmt0"));
+            t.addDevice(new Host(3, "H1", "10.0.0.1"));
+            t.addDevice(new Host(4, "H2", "10.0.0.2"));
 
-        connect("R1", "S1", Link{0.5, 100.0, 0.999});
-        connect("S1", "H1", Link{1.0, 100.0, 0.999});
-        connect("R1", "H2", Link{3.0, 20.0, 0.98});
+            t.connect("R1", "S1", Link{0.5, 100.0, 0.999});
+            t.connect("S1", "H1", Link{1.0, 100.0, 0.999});
+            t.connect("R1", "H2", Link{3.0, 20.0, 0.98});
+        });
     }
 
     // (М26) знайти маршрут між src та dst (імена вузлів), використовуючи алгоритм
@@ -126,11 +286,77 @@ public:
         const std::string& dst,
         std::size_t payloadBytes) const
     {
-        return algo.route(graph_, src, dst, payloadBytes);
+        TopologySnapshot g = snapshot();
+        return algo.route(*g, src, dst, payloadBytes);
     }
 
+    // (М40) статичний варіант: без vtable, без тимчасового графа; результат — у out
+    template <StaticRoutingAlgorithm Algo>
+    bool findRoute(Algo& algo,
+                   const std::string& src,
+                   const std::string& dst,
+                   std::size_t payloadBytes,
+                   std::vector<std::string>& out) const
+    {
+        TopologySnapshot g = snapshot();
+        return algo.route(*g, src, dst, payloadBytes, out);
+    }
+
+    // findRoute<Algo>(...): робочі буфери алгоритму — свої для кожного потоку
+    template <StaticRoutingAlgorithm Algo = StaticDijkstraRouting<>>
+    bool findRoute(const std::string& src,
+                   const std::string& dst,
+                   std::size_t payloadBytes,
+                   std::vector<std::string>& out) const
+    {
+        thread_local Algo algo;
+        return findRoute(algo, src, dst, payloadBytes, out);
+    }
+
+    // (М46) result[j] — маршрут для payloads[j]; топологія перетворюється у SoA один раз на всі розміри
+    std::vector<std::vector<std::string>> findRoutes(
+        const std::string& src,
+        const std::string& dst,
+        const std::vector<std::size_t>& payloads) const
+    {
+        std::shared_ptr<const LinkArrays> links = linkArrays();
+        thread_local PayloadSweepRouting sweep;
+        std::vector<std::vector<std::string>> result;
+        sweep.route(*links, src, dst, payloads, result);
+        return result;
+    }
+
+    // (М53) аналіз поточного знімка; зручно викликати після loadTopology()
+    TopologyReport analyzeTopology() const {
+        std::shared_ptr<const LinkArrays> links = linkArrays();
+        const DenseGraph<std::string>& d = links->topo;
+        UndirectedCsr undirected = UndirectedCsr::fromDirected(d);
+
+        TopologyReport report;
+        report.stronglyConnectedComponents = stronglyConnectedComponents(d).count;
+        for (std::uint32_t u : articulationPoints(undirected))
+            report.articulationPoints.push_back(d.nodes[u]);
+        for (auto [a, b] : bridges(undirected))
+            report.bridges.push_back({d.nodes[a], d.nodes[b]});
+        return report;
+    }
+
+#ifdef NETSIM_HAS_PROCESS_SHARDS
+    // (М65) розбити поточну версію на k шардів (k процесів); пакети — через inject(), запуск — run().
+    // Процеси ділять лише роботу CPU: вся топологія лишається в пам'яті цього процесу (і в образі воркерів)
+    ShardedSimulator shard(std::uint32_t shards, double imbalance = 0.03) const {
+        return ShardedSimulator(*linkArrays(), shards, imbalance);
+    }
+#endif
+
     // (М27) відправити пакет за маршрутом (зменшуючи TTL, накопичуючи час)
     double sendPacket(const std::vector<std::string>& path, Packet& pkt) const {
+        return sendPacket(*snapshot(), path, pkt);
+    }
+
+    // те саме, але на конкретній версії топології (щоб маршрут і передача бачили один стан)
+    double sendPacket(const Graph<std::string, Link>& graph,
+                      const std::vector<std::string>& path, Packet& pkt) const {
         if (path.size() < 2) return 0.0;
         double totalSeconds = 0.0;
         pkt.addHop(path.front());
@@ -142,15 +368,19 @@ public:
 
             // знайти Link(u->v)
             double edgeCost = 1e9;
-            auto it = graph_.data().find(u);
-            if (it != graph_.data().end()) {
-                for (auto& [to, link] : it->second) {
-                    if (to == v) {
-                        edgeCost = link.costForBytes(pkt.size());
-                        break;
+            {
+                NETSIM_METRIC_TIMER(HopCostNs);
+                auto it = graph.data().find(u);
+                if (it != graph.data().end()) {
+                    for (auto& [to, link] : it->second) {
+                        if (to == v) {
+                            edgeCost = link.costForBytes(pkt.size());
+                            break;
+                        }
                     }
                 }
             }
+            NETSIM_METRIC_ADD(HopsSimulated, 1);
 
             totalSeconds += edgeCost;
             pkt.decTTL();
@@ -166,6 +396,7 @@ public:
      EDGES:
      R1 S1 0.5 100 0.999 */
     void saveTopology(const std::string& filename) const {
+        std::lock_guard<std::mutex> lock(writeMutex_);
         std::ofstream out(filename);
         if (!out) throw std::runtime_error("Cannot open file for writing");
         out << "NODES:\n";
@@ -184,39 +415,65 @@ public:
     }
 
     // (М29) завантажити топологію з такого самого формату (для простоти: пристрої створюються як Router/Switch/Host за тегом у файлі)
+    // файл розбирається в локальні граф і реєстр; graph_/devices_ замінюються і публікуються лише
+    // після успішного розбору, тож помилка у файлі залишає попередню топологію недоторканою
     void loadTopology(const std::string& filename) {
-        // очистка (видалення старих пристроїв)
-        for (auto& [k, ptr] : devices_) delete ptr;
-        devices_.clear();
-        graph_.clear();
-
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        NETSIM_METRIC_TIMER(TopologyLoadNs);
         std::ifstream in(filename);
         if (!in) throw std::runtime_error("Cannot open file for reading");
-        std::string line;
-        enum Section { NONE, NODES, EDGES } sect = NONE;
-        while (std::getline(in, line)) {
-            if (line == "NODES:") { sect = NODES; continue; }
-            if (line == "EDGES:") { sect = EDGES; continue; }
-            if (line.empty() || line[0] == '#') continue;
-
-            std::istringstream iss(line);
-            if (sect == NODES) {
-                std::string name, kind;
-                iss >> name >> kind;
-                if (kind == "Router") addDevice(new Router((int)devices_.size()+1, name));
-                else if (kind == "Switch") addDevice(new Switch((int)devices_.size()+1, name));
-                else if (kind == "Host") addDevice(new Host((int)devices_.size()+1, name, "0.0.0.0"));
-                else addDevice(new Router((int)devices_.size()+1, name)); // за замовч.
-            } else if (sect == EDGES) {
-                std::string u, v; double lat, bw, rel;
-                iss >> u >> v >> lat >> bw >> rel;
-                connect(u, v, Link{lat, bw, rel}, false);
+
+        Graph<std::string, Link> graph;
+        std::map<std::string, Device*> devices;
+        try {
+            auto add = [&](Device* d) {
+                Device*& slot = devices[d->name()];
+                delete slot; // повторне ім'я у NODES: лишається останній пристрій
+                slot = d;
+                graph.addNode(d->name());
+            };
+
+            std::string line;
+            enum Section { NONE, NODES, EDGES } sect = NONE;
+            while (std::getline(in, line)) {
+                NETSIM_METRIC_ADD(BytesParsed, line.size() + 1); // +1 за '\n'
+                if (line == "NODES:") { sect = NODES; continue; }
+                if (line == "EDGES:") { sect = EDGES; continue; }
+                if (line.empty() || line[0] == '#') continue;
+
+                std::istringstream iss(line);
+                if (sect == NODES) {
+                    std::string name, kind;
+                    if (!(iss >> name)) throw std::runtime_error("Malformed NODES line: " + line);
+                    iss >> kind;
+                    if (kind == "Router") add(new Router((int)devices.size()+1, name));
+                    else if (kind == "Switch") add(new Switch((int)devices.size()+1, name));
+                    else if (kind == "Host") add(new Host((int)devices.size()+1, name, "0.0.0.0"));
+                    else add(new Router((int)devices.size()+1, name)); // за замовч.
+                } else if (sect == EDGES) {
+                    std::string u, v; double lat, bw, rel;
+                    if (!(iss >> u >> v >> lat >> bw >> rel))
+                        throw std::runtime_error("Malformed EDGES line: " + line);
+                    if (!graph.hasNode(u) || !graph.hasNode(v))
+                        throw std::runtime_error("Unknown node in EDGES line: " + line);
+                    graph.addEdge(u, v, Link{lat, bw, rel});
+                }
             }
+        } catch (...) {
+            for (auto& [k, ptr] : devices) delete ptr;
+            throw;
         }
+
+        // успіх: заміна старих пристроїв і графа, одна публікація
+        for (auto& [k, ptr] : devices_) delete ptr;
+        devices_ = std::move(devices);
+        graph_ = std::move(graph);
+        publish();
     }
 
     // (М30) допоміжний друк реєстру пристроїв
     void printDevices() const {
+        std::lock_guard<std::mutex> lock(writeMutex_);
         std::cout << "Devices:\n";
         for (auto& [name, dev] : devices_) {
             std::cout << "  " << std::left << std::setw(6) << name
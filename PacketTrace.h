@@ -0,0 +1,335 @@
+#ifndef PACKETTRACE_H
+#define PACKETTRACE_H
+
+/*
+КЛАСИ/ТИПИ У ФАЙЛІ:
+ 42) enum class TraceEvent - тип події в трасі (Inject / Hop / Deliver / Drop)
+ 43) struct TraceRecord - запис фіксованого розміру (24 байти)
+ 44) class PacketTraceWriter - потоковий буферизований запис траси блоками
+ 45) class PacketTraceReader - послідовне читання траси (next() або range-for)
+
+ПОЛЯ:
+  - TraceRecord: timestampNs, packetId, nodeId, linkId, event - 5
+  - PacketTraceWriter: out_, compress_, blockRecords_, buffer_, scratch_, written_ - 6
+  - PacketTraceReader: in_, compressed_, block_, pos_, scratch_, fileSize_ - 6
+  разом: 17
+
+НЕТРИВІАЛЬНІ МЕТОДИ:
+  (М66) PacketTraceWriter::write(record) - запис у буфер; повний блок скидається одним write
+  (М67) PacketTraceWriter::flush() - скидання блоку (сирого або стиснутого)
+  (М68) PacketTraceReader::next(record) - наступний запис (з підвантаженням блоку)
+  (М69) PacketTraceReader::loadBlock() - читання й розпакування одного блоку
+  (М70) sendPacketTraced(...) - sendPacket, який пише події в трасу замість рядків у Packet::hops_
+  разом: 5
+
+ФОРМАТ ФАЙЛУ:
+  заголовок (16 байт): "NSTRACE1", u32 версія (1), u32 прапорці (біт 0 — стиснення)
+  далі блоки: u32 кількість записів, u32 розмір даних у байтах, дані
+    - без стиснення: записи TraceRecord як є (читаються одним read прямо в масив);
+    - зі стисненням: для кожного запису varint(zigzag(Δ timestamp)), varint(packetId),
+      varint(nodeId), varint(linkId + 1), 1 байт події. Δ рахується від попереднього запису
+      блоку (перший — від 0), тож кожен блок розпаковується незалежно.
+  числа пишуться в порядку байтів машини (little-endian на x86/ARM).
+
+ПРИМІТКИ:
+  - стиснення власне (дельта + varint), без зовнішніх бібліотек: типовий запис займає
+    8-12 байт замість 24, а кодування — кілька операцій на поле;
+  - помилки відкриття/читання — std::runtime_error, як і в NetworkSimulator; заголовок блоку
+    (кількість записів, розмір, залишок файлу) перевіряється до будь-якого виділення пам'яті;
+  - блок письменника обмежено maxBlockRecords (2^24), щоб розмір даних блоку вміщався в u32.
+*/
+
+#include "Network.h"
+#include "PayloadSweep.h" // LinkArrays: ID вузлів і каналів для sendPacketTraced
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+enum class TraceEvent : std::uint8_t {
+    Inject  = 0, // пакет з'явився у першому вузлі маршруту
+    Hop     = 1, // пакет прибув у nodeId каналом linkId
+    Deliver = 2, // пакет досяг останнього вузла
+    Drop    = 3, // TTL вичерпано до кінця маршруту
+};
+
+struct TraceRecord {
+    static constexpr std::uint32_t noLink = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t noNode = std::numeric_limits<std::uint32_t>::max(); // вузла немає в топології
+
+    std::uint64_t timestampNs = 0;
+    std::uint32_t packetId = 0;
+    std::uint32_t nodeId = 0;
+    std::uint32_t linkId = noLink;
+    TraceEvent    event = TraceEvent::Inject;
+    std::uint8_t  reserved[3] = {0, 0, 0};
+
+    bool operator==(const TraceRecord& o) const {
+        return timestampNs == o.timestampNs && packetId == o.packetId && nodeId == o.nodeId
+            && linkId == o.linkId && event == o.event;
+    }
+};
+static_assert(sizeof(TraceRecord) == 24, "TraceRecord must stay 24 bytes (file format)");
+
+class PacketTraceWriter {
+    std::ofstream              out_;
+    bool                       compress_;
+    std::size_t                blockRecords_;
+    std::vector<TraceRecord>   buffer_;
+    std::vector<unsigned char> scratch_; // стиснутий блок
+    std::uint64_t              written_ = 0;
+
+    template <typename T>
+    void writeRaw(const T& value) { out_.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    void putVarint(std::uint64_t v) {
+        while (v >= 0x80) { scratch_.push_back(static_cast<unsigned char>(v | 0x80)); v >>= 7; }
+        scratch_.push_back(static_cast<unsigned char>(v));
+    }
+
+public:
+    // верхня межа блоку: розмір даних блоку пишеться як u32, а 2^24 записи займають 384 МіБ
+    // без стиснення і не більше 26 байт на запис (436 МіБ) зі стисненням — далеко від 4 ГіБ
+    static constexpr std::size_t maxBlockRecords = std::size_t{1} << 24;
+
+    explicit PacketTraceWriter(const std::string& filename, bool compress = false,
+                               std::size_t blockRecords = 1 << 15)
+        : out_(filename, std::ios::binary | std::ios::trunc), compress_(compress),
+          blockRecords_(std::clamp<std::size_t>(blockRecords, 1, maxBlockRecords))
+    {
+        if (!out_) throw std::runtime_error("Cannot open trace file for writing");
+        buffer_.reserve(blockRecords_);
+        out_.write("NSTRACE1", 8);
+        writeRaw(std::uint32_t{1});
+        writeRaw(std::uint32_t{compress_ ? 1u : 0u});
+    }
+
+    ~PacketTraceWriter() {
+        try { flush(); } catch (...) {} // деструктор не кидає; для перевірки помилок — close()
+    }
+
+    PacketTraceWriter(const PacketTraceWriter&) = delete;
+    PacketTraceWriter& operator=(const PacketTraceWriter&) = delete;
+
+    // (М66)
+    void write(const TraceRecord& r) {
+        buffer_.push_back(r);
+        if (buffer_.size() == blockRecords_) flush();
+    }
+
+    void write(double seconds, std::uint32_t packetId, std::uint32_t nodeId,
+               std::uint32_t linkId, TraceEvent event)
+    {
+        // насичення: після ~18 "відсутніх" хопів по 1e9 с наносекунди не вміщаються навіть у u64
+        // (llround переповнювався вже після ~9.2e9 с); від'ємний час і NaN -> 0
+        constexpr double maxNs = 18446744073709551616.0; // 2^64
+        const double ns = std::round(seconds * 1e9);
+        TraceRecord r;
+        r.timestampNs = !(ns > 0.0) ? 0
+                      : ns >= maxNs ? std::numeric_limits<std::uint64_t>::max()
+                                    : static_cast<std::uint64_t>(ns);
+        r.packetId = packetId;
+        r.nodeId = nodeId;
+        r.linkId = linkId;
+        r.event = event;
+        write(r);
+    }
+
+    // (М67)
+    void flush() {
+        if (buffer_.empty()) return;
+        const auto count = static_cast<std::uint32_t>(buffer_.size());
+        if (!compress_) {
+            writeRaw(count);
+            writeRaw(static_cast<std::uint32_t>(count * sizeof(TraceRecord)));
+            out_.write(reinterpret_cast<const char*>(buffer_.data()),
+                       static_cast<std::streamsize>(count * sizeof(TraceRecord)));
+        } else {
+            scratch_.clear();
+            std::uint64_t prev = 0;
+            for (const TraceRecord& r : buffer_) {
+                const auto delta = static_cast<std::int64_t>(r.timestampNs - prev);
+                putVarint((static_cast<std::uint64_t>(delta) << 1) ^ static_cast<std::uint64_t>(delta >> 63));
+                putVarint(r.packetId);
+                putVarint(r.nodeId);
+                putVarint(static_cast<std::uint32_t>(r.linkId + 1)); // noLink -> 0
+                scratch_.push_back(static_cast<unsigned char>(r.event));
+                prev = r.timestampNs;
+            }
+            writeRaw(count);
+            writeRaw(static_cast<std::uint32_t>(scratch_.size()));
+            out_.write(reinterpret_cast<const char*>(scratch_.data()),
+                       static_cast<std::streamsize>(scratch_.size()));
+        }
+        written_ += count;
+        buffer_.clear();
+        if (!out_) throw std::runtime_error("Failed to write trace file");
+    }
+
+    void close() { flush(); out_.close(); }
+
+    std::uint64_t recordsWritten() const { return written_ + buffer_.size(); }
+};
+
+class PacketTraceReader {
+    std::ifstream              in_;
+    bool                       compressed_ = false;
+    std::vector<TraceRecord>   block_;
+    std::size_t                pos_ = 0;
+    std::vector<unsigned char> scratch_;
+    std::uint64_t              fileSize_ = 0;
+
+    template <typename T>
+    bool readRaw(T& value) { return static_cast<bool>(in_.read(reinterpret_cast<char*>(&value), sizeof(T))); }
+
+    static std::uint64_t getVarint(const unsigned char*& p, const unsigned char* end) {
+        std::uint64_t v = 0;
+        for (int shift = 0; p < end && shift < 64; shift += 7) {
+            const unsigned char byte = *p++;
+            v |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return v;
+        }
+        throw std::runtime_error("Corrupted trace block");
+    }
+
+    // (М69)
+    bool loadBlock() {
+        std::uint32_t count = 0, bytes = 0;
+        if (!readRaw(count)) return false; // кінець файлу
+        if (!readRaw(bytes)) throw std::runtime_error("Truncated trace file");
+        // заголовок перевіряється до виділення пам'яті: зіпсований count не має стати bad_alloc
+        const std::uint64_t minBytes = compressed_ ? std::uint64_t{5} : sizeof(TraceRecord); // байт на запис
+        if (compressed_ ? count > bytes / minBytes : std::uint64_t{count} * minBytes != bytes)
+            throw std::runtime_error("Corrupted trace block");
+        if (bytes > fileSize_ - static_cast<std::uint64_t>(in_.tellg()))
+            throw std::runtime_error("Truncated trace file");
+        block_.resize(count);
+        pos_ = 0;
+        if (!compressed_) {
+            if (!in_.read(reinterpret_cast<char*>(block_.data()), bytes))
+                throw std::runtime_error("Truncated trace file");
+            return true;
+        }
+        scratch_.resize(bytes);
+        if (!in_.read(reinterpret_cast<char*>(scratch_.data()), bytes))
+            throw std::runtime_error("Truncated trace file");
+        const unsigned char* p = scratch_.data();
+        const unsigned char* end = p + scratch_.size();
+        std::uint64_t prev = 0;
+        for (TraceRecord& r : block_) {
+            const std::uint64_t zz = getVarint(p, end);
+            r.timestampNs = prev + ((zz >> 1) ^ (~(zz & 1) + 1));
+            r.packetId = static_cast<std::uint32_t>(getVarint(p, end));
+            r.nodeId = static_cast<std::uint32_t>(getVarint(p, end));
+            r.linkId = static_cast<std::uint32_t>(getVarint(p, end)) - 1;
+            if (p >= end) throw std::runtime_error("Corrupted trace block");
+            r.event = static_cast<TraceEvent>(*p++);
+            prev = r.timestampNs;
+        }
+        return true;
+    }
+
+public:
+    explicit PacketTraceReader(const std::string& filename) : in_(filename, std::ios::binary) {
+        if (!in_) throw std::runtime_error("Cannot open trace file for reading");
+        in_.seekg(0, std::ios::end);
+        fileSize_ = static_cast<std::uint64_t>(in_.tellg());
+        in_.seekg(0, std::ios::beg);
+        char magic[8];
+        std::uint32_t version = 0, flags = 0;
+        if (!in_.read(magic, 8) || std::memcmp(magic, "NSTRACE1", 8) != 0
+            || !readRaw(version) || version != 1 || !readRaw(flags))
+            throw std::runtime_error("Not a packet trace file");
+        compressed_ = (flags & 1u) != 0;
+    }
+
+    bool compressed() const { return compressed_; }
+
+    // (М68) false — записи закінчились
+    bool next(TraceRecord& r) {
+        while (pos_ == block_.size()) {
+            if (!loadBlock()) return false;
+        }
+        r = block_[pos_++];
+        return true;
+    }
+
+    // for (const TraceRecord& r : reader) { ... } — одноразовий прохід
+    class iterator {
+        PacketTraceReader* reader_ = nullptr;
+        TraceRecord        current_;
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = TraceRecord;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const TraceRecord*;
+        using reference = const TraceRecord&;
+
+        iterator() = default;
+        explicit iterator(PacketTraceReader* r) : reader_(r) { ++*this; }
+
+        reference operator*() const { return current_; }
+        pointer operator->() const { return &current_; }
+        iterator& operator++() {
+            if (reader_ && !reader_->next(current_)) reader_ = nullptr;
+            return *this;
+        }
+        bool operator==(const iterator& o) const { return reader_ == o.reader_; }
+        bool operator!=(const iterator& o) const { return reader_ != o.reader_; }
+    };
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+};
+
+// (М70) як NetworkSimulator::sendPacket, але замість рядків у pkt.hops() пише події в трасу;
+// nodeId / linkId — ID вершини і ребра в links (DenseGraph / CSR-порядок LinkArrays).
+// Невідомий вузол, як і в sendPacket, — не помилка: хоп до/з нього коштує 1e9, nodeId = noNode
+// (npos у DenseGraph має те саме значення), linkId = noLink
+inline double sendPacketTraced(const LinkArrays& links, const std::vector<std::string>& path,
+                               Packet& pkt, PacketTraceWriter& trace,
+                               std::uint32_t packetId, double startSeconds = 0.0)
+{
+    if (path.size() < 2) return 0.0;
+    static_assert(TraceRecord::noNode == DenseGraph<std::string>::npos);
+    std::uint32_t u = links.topo.indexOf(path.front());
+    const double bytes = static_cast<double>(pkt.size());
+    double totalSeconds = 0.0;
+    trace.write(startSeconds, packetId, u, TraceRecord::noLink, TraceEvent::Inject);
+
+    for (std::size_t i = 1; i < path.size(); ++i) {
+        if (pkt.ttl() <= 0) {
+            trace.write(startSeconds + totalSeconds, packetId, u, TraceRecord::noLink, TraceEvent::Drop);
+            return totalSeconds;
+        }
+        const std::uint32_t v = links.topo.indexOf(path[i]);
+
+        // знайти Link(u->v); та сама арифметика, що й у Link::costForBytes
+        double edgeCost = 1e9;
+        std::uint32_t link = TraceRecord::noLink;
+        const std::uint32_t first = u == TraceRecord::noNode ? 0 : links.topo.offsets[u];
+        const std::uint32_t last = u == TraceRecord::noNode ? 0 : links.topo.offsets[u + 1];
+        for (std::uint32_t e = first; e < last && v != TraceRecord::noNode; ++e) {
+            if (links.topo.targets[e] == v) {
+                edgeCost = links.baseSeconds[e] + bytes / links.bytesPerSecond[e];
+                link = e;
+                break;
+            }
+        }
+
+        totalSeconds += edgeCost;
+        pkt.decTTL();
+        trace.write(startSeconds + totalSeconds, packetId, v, link, TraceEvent::Hop);
+        u = v;
+    }
+    trace.write(startSeconds + totalSeconds, packetId, u, TraceRecord::noLink, TraceEvent::Deliver);
+    return totalSeconds;
+}
+
+#endif //PACKETTRACE_H
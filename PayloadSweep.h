@@ -0,0 +1,195 @@
+#ifndef PAYLOADSWEEP_H
+#define PAYLOADSWEEP_H
+
+/*
+КЛАСИ/ТИПИ У ФАЙЛІ:
+ 25) struct LinkArrays - топологія (CSR) + атрибути Link окремими масивами (structure-of-arrays)
+ 26) class PayloadSweepRouting - Дейкстра для кількох розмірів пакета за один прохід
+
+ПОЛЯ:
+  - LinkArrays: topo, latencyMs, bandwidthMbps, reliability, baseSeconds, bytesPerSecond - 6
+  - PayloadSweepRouting: costs_, dist_, parent_, key_, heap_ - 5
+  разом: 11
+
+НЕТРИВІАЛЬНІ МЕТОДИ:
+  (М43) LinkArrays::fromGraph(g) - перетворення Graph<std::string, Link> у SoA
+  (М44) linkCostsForPayloads(links, payloads, k, out) - векторизоване ядро вартостей ребер
+  (М45) PayloadSweepRouting::route(...) - найкоротші шляхи src->dst для всіх розмірів
+  разом: 3
+
+ПРИМІТКИ:
+  - ядро (М44) — цикл base[e] + bytes / rate[e] по суміжних масивах без порівнянь і розгалужень;
+    внутрішній цикл явно позначено #pragma omp simd (NETSIM_SIMD_LOOP; CMake додає -fopenmp-simd,
+    якщо компілятор його знає), а вказівники — __restrict, тож він векторизується (SSE/AVX/NEON
+    залежно від цілі) і при -O2, а не лише при -O3 — без інтринсиків, щоб код залишився переносним. Випадок bandwidth == 0 закладено в масиви
+    заздалегідь (rate = +inf, base += 1e9), тому результат побітово збігається з Link::costForBytes;
+  - PayloadSweepRouting зберігає K відстаней на вершину; вершина повертається в купу, якщо
+    покращилась будь-яка з них (label-correcting), ключ купи — сума K відстаней.
+    Для близьких розмірів порядок обробки майже однаковий, тож повторних обробок мало
+    і прохід коштує близько одного запиту + K·E простих операцій;
+  - при рівних за вартістю шляхах вибраний шлях може відрізнятися від DijkstraRouting.
+*/
+
+#include "DenseGraph.h"
+#include "Network.h"
+#include "Metrics.h"
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+// явна векторизація циклу: діє з -fopenmp-simd (CMake визначає NETSIM_OPENMP_SIMD разом із прапорцем)
+#if defined(NETSIM_OPENMP_SIMD)
+#define NETSIM_SIMD_LOOP _Pragma("omp simd")
+#else
+#define NETSIM_SIMD_LOOP
+#endif
+
+struct LinkArrays {
+    DenseGraph<std::string> topo;      // ребро e: topo.targets[e], атрибути — у масивах нижче
+    std::vector<double> latencyMs;
+    std::vector<double> bandwidthMbps;
+    std::vector<double> reliability;
+    // похідні масиви для ядра: cost = baseSeconds[e] + bytes / bytesPerSecond[e]
+    std::vector<double> baseSeconds;    // latency (с), +1e9 якщо bandwidth == 0
+    std::vector<double> bytesPerSecond; // bandwidth (байт/с), +inf якщо bandwidth == 0
+
+    std::size_t edgeCount() const { return topo.edgeCount(); }
+    Link link(std::size_t e) const { return Link{latencyMs[e], bandwidthMbps[e], reliability[e]}; }
+
+    // (М43) один прохід по графу: CSR + масиви атрибутів у тому ж порядку ребер
+    static LinkArrays fromGraph(const Graph<std::string, Link>& g) {
+        LinkArrays a;
+        a.topo = DenseGraph<std::string>::fromGraph(g, [&a](const Link& link) {
+            a.latencyMs.push_back(link.latencyMs);
+            a.bandwidthMbps.push_back(link.bandwidthMbps);
+            a.reliability.push_back(link.reliability);
+            // та сама арифметика, що й у Link::costForBytes (bytes / inf == 0, x + 0 == x)
+            const bool hasBandwidth = link.bandwidthMbps > 0.0;
+            a.baseSeconds.push_back(hasBandwidth ? link.latencyMs / 1000.0
+                                                 : link.latencyMs / 1000.0 + 1e9);
+            a.bytesPerSecond.push_back(hasBandwidth ? link.bandwidthMbps * 1'000'000.0
+                                                    : std::numeric_limits<double>::infinity());
+        });
+        return a;
+    }
+};
+
+// (М44) out[j * E + e] = вартість ребра e для payloads[j] (як Link::costForBytes)
+inline void linkCostsForPayloads(const LinkArrays& links,
+                                 const std::size_t* payloads, std::size_t k,
+                                 double* out)
+{
+    const std::size_t edges = links.edgeCount();
+    const double* __restrict base = links.baseSeconds.data();
+    const double* __restrict rate = links.bytesPerSecond.data();
+    for (std::size_t j = 0; j < k; ++j) {
+        const double bytes = static_cast<double>(payloads[j]);
+        double* __restrict row = out + j * edges;
+        NETSIM_SIMD_LOOP
+        for (std::size_t e = 0; e < edges; ++e)
+            row[e] = base[e] + bytes / rate[e];
+    }
+}
+
+class PayloadSweepRouting {
+    static constexpr std::uint32_t npos = DenseGraph<std::string>::npos;
+    using HeapItem = std::pair<double, std::uint32_t>;
+
+    // робочі буфери (перевикористовуються між викликами)
+    std::vector<double>        costs_;  // K × E
+    std::vector<double>        dist_;   // V × K
+    std::vector<std::uint32_t> parent_; // V × K
+    std::vector<double>        key_;    // V: поточний ключ вершини в купі
+    std::vector<HeapItem>      heap_;
+
+public:
+    // (М45) out[j] — шлях src..dst для payloads[j]; false, якщо вершини немає або шлях відсутній
+    bool route(const LinkArrays& links,
+               const std::string& src,
+               const std::string& dst,
+               const std::vector<std::size_t>& payloads,
+               std::vector<std::vector<std::string>>& out)
+    {
+        const std::size_t k = payloads.size();
+        const std::size_t n = links.topo.size();
+        const std::size_t edges = links.edgeCount();
+        out.resize(k);
+        const std::uint32_t s = links.topo.indexOf(src), t = links.topo.indexOf(dst);
+        if (s == npos || t == npos || k == 0) {
+            for (auto& p : out) p.clear();
+            return false;
+        }
+
+        costs_.resize(k * edges);
+        linkCostsForPayloads(links, payloads.data(), k, costs_.data());
+
+        const double inf = std::numeric_limits<double>::infinity();
+        dist_.assign(n * k, inf);
+        parent_.assign(n * k, npos);
+        key_.assign(n, inf);
+        heap_.clear();
+
+        auto cmp = std::greater<HeapItem>{}; // мін-купа
+        for (std::size_t j = 0; j < k; ++j) dist_[s * k + j] = 0.0;
+        key_[s] = 0.0;
+        heap_.push_back({0.0, s});
+        NETSIM_METRIC_ADD(HeapPushes, 1);
+
+        while (!heap_.empty()) {
+            std::pop_heap(heap_.begin(), heap_.end(), cmp);
+            auto [ku, u] = heap_.back(); heap_.pop_back();
+            if (ku != key_[u]) { // застарілий елемент
+                NETSIM_METRIC_ADD(StalePops, 1);
+                continue;
+            }
+            NETSIM_METRIC_ADD(VerticesSettled, 1);
+
+            const double* du = &dist_[u * k];
+            const std::uint32_t begin = links.topo.offsets[u], end = links.topo.offsets[u + 1];
+            NETSIM_METRIC_ADD(EdgesRelaxed, end - begin);
+            for (std::uint32_t e = begin; e < end; ++e) {
+                const std::uint32_t v = links.topo.targets[e];
+                double* dv = &dist_[v * k];
+                bool improved = false;
+                for (std::size_t j = 0; j < k; ++j) { // релаксація всіх K відстаней
+                    const double nd = du[j] + costs_[j * edges + e];
+                    if (nd < dv[j]) {
+                        dv[j] = nd;
+                        parent_[v * k + j] = u;
+                        improved = true;
+                    }
+                }
+                if (improved) {
+                    double key = 0.0;
+                    for (std::size_t j = 0; j < k; ++j) key += dv[j];
+                    key_[v] = key;
+                    heap_.push_back({key, v});
+                    std::push_heap(heap_.begin(), heap_.end(), cmp);
+                    NETSIM_METRIC_ADD(HeapPushes, 1);
+                }
+            }
+        }
+
+        if (dist_[t * k] == inf) { // досяжність не залежить від розміру пакета
+            for (auto& p : out) p.clear();
+            return false;
+        }
+        for (std::size_t j = 0; j < k; ++j) {
+            std::vector<std::string>& path = out[j];
+            std::size_t len = 1;
+            for (std::uint32_t cur = t; cur != s; cur = parent_[cur * k + j]) ++len;
+            path.resize(len);
+            std::size_t i = len;
+            for (std::uint32_t cur = t; ; cur = parent_[cur * k + j]) {
+                path[--i] = links.topo.nodes[cur];
+                if (cur == s) break;
+            }
+        }
+        return true;
+    }
+};
+
+#endif //PAYLOADSWEEP_H
@@ -0,0 +1,608 @@
+#ifndef SHARDEDSIMULATION_H
+#define SHARDEDSIMULATION_H
+
+/*
+КЛАСИ/ТИПИ У ФАЙЛІ:
+ 36) struct ShardTopology - частина топології, якою володіє один шард (лише його вершини і канали)
+ 37) struct ShardPacket - пакет у дорозі (повідомлення між шардами)
+ 38) struct ShardedPacketResult - підсумок доставки одного пакета
+ 39) struct ShardedRunStats - кількість раундів синхронізації і міжшардових повідомлень
+ 40) class ShardChannel - кінець socketpair між координатором і процесом-воркером
+ 41) class ShardedSimulator - шардова симуляція з консервативною синхронізацією часу
+ 48) struct WireBuffer - тіло повідомлення: POD-поля і масиви підряд
+ 49) enum class ShardMessage - тип повідомлення протоколу координатор <-> воркер
+
+ПОЛЯ:
+  - ShardTopology: shard, nodes, offsets, targets, baseSeconds, bytesPerSecond - 6
+  - ShardPacket: id, path, hop, ttl, sizeBytes, startSeconds, timeSeconds - 7
+  - ShardedPacketResult: id, seconds, ttlLeft, hops, delivered - 5
+  - ShardedRunStats: rounds, crossShardMessages - 2
+  - ShardChannel: fd_, worker_ - 2
+  - ShardedSimulator: names_, partition_, lookahead_, pending_, stats_, workers_ - 6
+  - WireBuffer: bytes, pos - 2
+  разом: 30
+
+НЕТРИВІАЛЬНІ МЕТОДИ:
+  (М59) ShardTopology::extract(links, owner, shard) - вирізати вершини і канали шарда
+  (М60) ShardTopology::hopCost(...) - вартість каналу (як Link::costForBytes) або 1e9, якщо його немає
+  (М61) ShardedSimulator::ShardedSimulator(links, shards) - процеси-воркери + розбиття + розсилка шардів
+  (М62) ShardedSimulator::inject(...) - поставити пакет у чергу шарда, що володіє першим вузлом
+  (М63) ShardedSimulator::run() - координатор: раунди синхронізації і пересилання граничних пакетів
+  (М64) ShardedSimulator::runShard(...) - один запуск шарда у процесі-воркері
+  (М74) ShardChannel::send/receive(...) - кадр повідомлення (тип + розмір + тіло) через сокет
+  (М75) ShardTopology::write/read, ShardPacket::write/read - серіалізація для передачі воркерам
+  разом: 8
+
+ПРИМІТКИ:
+  - семантика хопа така сама, як у NetworkSimulator::sendPacket: TTL перевіряється перед хопом,
+    відсутній канал коштує 1e9, підсумковий час — сума вартостей пройдених каналів;
+  - кожен шард — окремий процес (fork), з'єднаний з координатором через socketpair. Координатор
+    вирізає ShardTopology по одній і надсилає своєму воркеру; обробка подій шарда відбувається
+    лише у воркері. Шардування розподіляє між процесами ЛИШЕ роботу CPU, а не пам'ять: процес-
+    координатор — це процес NetworkSimulator, у якому вся топологія (graph_, опублікована версія,
+    LinkArrays) уже зібрана, і кожен воркер форкається з цього повного образу. Отже пікова пам'ять
+    процесу не менша за всю топологію — симулювати граф, що не вміщається в один процес, так не
+    вийде (для цього потрібні потокове читання і розбиття без повного графа в пам'яті);
+  - ShardPacket — самодостатнє повідомлення (маршрут глобальними ID), тому воркеру не потрібні
+    чужі частини графа: якщо наступний вузол не свій, пакет іде координатору, а той за таблицею
+    власників пересилає його потрібному шарду (зірка, без прямих з'єднань між воркерами);
+  - консервативна синхронізація (віконна): lookahead L = мінімальна затримка каналу, що
+    перетинає межу шардів (вартість хопа >= затримки). Кожен раунд воркери надсилають мінімальний
+    час своїх подій, координатор розсилає вікно [G, G + L) (G — глобальний мінімум), воркери
+    обробляють усе з часом < G + L і повертають граничні пакети — жоден з них не прибуде раніше
+    за G + L. Раунд: Min -> Window -> Outbox -> Packets; Stop, коли подій немає ніде;
+  - лише POSIX (fork, socketpair): на інших платформах NETSIM_HAS_PROCESS_SHARDS не визначено
+    і ShardedSimulator недоступний. Воркер закриває всі успадковані дескриптори, крім свого сокета
+    і stdin/stdout/stderr, і завершується (_exit) за Shutdown або EOF; деструктор ShardedSimulator
+    надсилає Shutdown і чекає на всі процеси. Помилки обміну — std::runtime_error.
+*/
+
+#include "GraphPartitioner.h"
+#include "PayloadSweep.h" // LinkArrays
+
+#if defined(__unix__) || defined(__APPLE__)
+#define NETSIM_HAS_PROCESS_SHARDS 1
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// числа пишуться в порядку байтів машини: обидва кінці — процеси однієї програми на одній машині
+struct WireBuffer {
+    std::vector<char> bytes;
+    std::size_t       pos = 0; // позиція читання
+
+    template <typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const char* p = reinterpret_cast<const char*>(&value);
+        bytes.insert(bytes.end(), p, p + sizeof(T));
+    }
+
+    template <typename T>
+    void putVector(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        put<std::uint64_t>(values.size());
+        const char* p = reinterpret_cast<const char*>(values.data());
+        bytes.insert(bytes.end(), p, p + values.size() * sizeof(T));
+    }
+
+    template <typename T>
+    T get() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (bytes.size() - pos < sizeof(T)) throw std::runtime_error("Corrupted shard message");
+        T value;
+        std::memcpy(&value, bytes.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    template <typename T>
+    std::vector<T> getVector() {
+        const auto count = get<std::uint64_t>();
+        if (count > (bytes.size() - pos) / sizeof(T)) throw std::runtime_error("Corrupted shard message");
+        std::vector<T> values(count);
+        if (count > 0) std::memcpy(values.data(), bytes.data() + pos, count * sizeof(T));
+        pos += count * sizeof(T);
+        return values;
+    }
+};
+
+enum class ShardMessage : std::uint32_t {
+    Topology = 0, // координатор -> воркер: ShardTopology (один раз)
+    Packets  = 1, // координатор -> воркер: нові пакети (початок запуску або вхідні граничні)
+    Min      = 2, // воркер -> координатор: мінімальний час подій
+    Window   = 3, // координатор -> воркер: G і горизонт G + L
+    Outbox   = 4, // воркер -> координатор: пакети, наступний вузол яких у чужому шарді
+    Stop     = 5, // координатор -> воркер: подій немає, надіслати результати
+    Results  = 6, // воркер -> координатор: ShardedPacketResult[]
+    Shutdown = 7, // координатор -> воркер: завершитися (не покладаючись лише на EOF)
+};
+
+struct ShardTopology {
+    std::uint32_t shard = 0;
+    std::vector<std::uint32_t> nodes;          // глобальні ID власних вершин (за зростанням)
+    std::vector<std::uint32_t> offsets;        // CSR по власних вершинах
+    std::vector<std::uint32_t> targets;        // глобальні ID кінців каналів
+    std::vector<double>        baseSeconds;    // див. LinkArrays
+    std::vector<double>        bytesPerSecond;
+
+    std::uint32_t localIndex(std::uint32_t global) const {
+        auto it = std::lower_bound(nodes.begin(), nodes.end(), global);
+        return static_cast<std::uint32_t>(it - nodes.begin());
+    }
+
+    bool owns(std::uint32_t global) const {
+        const std::uint32_t i = localIndex(global);
+        return i < nodes.size() && nodes[i] == global;
+    }
+
+    // (М59)
+    static ShardTopology extract(const LinkArrays& links, const std::vector<std::uint32_t>& owner,
+                                 std::uint32_t shard)
+    {
+        ShardTopology t;
+        t.shard = shard;
+        t.offsets.push_back(0);
+        for (std::uint32_t u = 0; u < owner.size(); ++u) {
+            if (owner[u] != shard) continue;
+            t.nodes.push_back(u);
+            for (std::uint32_t e = links.topo.offsets[u]; e < links.topo.offsets[u + 1]; ++e) {
+                t.targets.push_back(links.topo.targets[e]);
+                t.baseSeconds.push_back(links.baseSeconds[e]);
+                t.bytesPerSecond.push_back(links.bytesPerSecond[e]);
+            }
+            t.offsets.push_back(static_cast<std::uint32_t>(t.targets.size()));
+        }
+        return t;
+    }
+
+    // (М60) перший канал u -> v, як і пошук у sendPacket
+    double hopCost(std::uint32_t globalU, std::uint32_t globalV, std::size_t bytes) const {
+        const std::uint32_t u = localIndex(globalU);
+        for (std::uint32_t e = offsets[u]; e < offsets[u + 1]; ++e)
+            if (targets[e] == globalV) return baseSeconds[e] + static_cast<double>(bytes) / bytesPerSecond[e];
+        return 1e9;
+    }
+
+    // (М75)
+    void write(WireBuffer& out) const {
+        out.put(shard);
+        out.putVector(nodes);
+        out.putVector(offsets);
+        out.putVector(targets);
+        out.putVector(baseSeconds);
+        out.putVector(bytesPerSecond);
+    }
+
+    static ShardTopology read(WireBuffer& in) {
+        ShardTopology t;
+        t.shard = in.get<std::uint32_t>();
+        t.nodes = in.getVector<std::uint32_t>();
+        t.offsets = in.getVector<std::uint32_t>();
+        t.targets = in.getVector<std::uint32_t>();
+        t.baseSeconds = in.getVector<double>();
+        t.bytesPerSecond = in.getVector<double>();
+        return t;
+    }
+};
+
+struct ShardPacket {
+    std::uint32_t              id = 0;
+    std::vector<std::uint32_t> path;      // глобальні ID вузлів маршруту
+    std::uint32_t              hop = 0;   // індекс поточного вузла в path
+    int                        ttl = 8;
+    std::size_t                sizeBytes = 512;
+    double                     startSeconds = 0.0;
+    double                     timeSeconds = 0.0; // коли пакет перебуває у path[hop]
+
+    // (М75)
+    void write(WireBuffer& out) const {
+        out.put(id);
+        out.put(hop);
+        out.put(ttl);
+        out.put<std::uint64_t>(sizeBytes);
+        out.put(startSeconds);
+        out.put(timeSeconds);
+        out.putVector(path);
+    }
+
+    static ShardPacket read(WireBuffer& in) {
+        ShardPacket p;
+        p.id = in.get<std::uint32_t>();
+        p.hop = in.get<std::uint32_t>();
+        p.ttl = in.get<int>();
+        p.sizeBytes = static_cast<std::size_t>(in.get<std::uint64_t>());
+        p.startSeconds = in.get<double>();
+        p.timeSeconds = in.get<double>();
+        p.path = in.getVector<std::uint32_t>();
+        return p;
+    }
+};
+
+struct ShardedPacketResult {
+    std::uint32_t id = 0;
+    double        seconds = 0.0;   // як повертає sendPacket: сума вартостей пройдених хопів
+    int           ttlLeft = 0;
+    std::uint32_t hops = 0;
+    bool          delivered = false;
+};
+
+struct ShardedRunStats {
+    std::size_t rounds = 0;
+    std::size_t crossShardMessages = 0;
+};
+
+// у координатора канал володіє і процесом-воркером: close() = EOF у воркера + очікування на нього
+class ShardChannel {
+    int   fd_ = -1;
+    pid_t worker_ = -1;
+
+    struct Header {
+        ShardMessage  type;
+        std::uint32_t reserved;
+        std::uint64_t size;
+    };
+
+    void writeAll(const void* data, std::size_t size) {
+        const char* p = static_cast<const char*>(data);
+        while (size > 0) {
+#ifdef MSG_NOSIGNAL
+            const ssize_t n = ::send(fd_, p, size, MSG_NOSIGNAL); // мертвий воркер — помилка, а не SIGPIPE
+#else
+            const ssize_t n = ::write(fd_, p, size);
+#endif
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) throw std::runtime_error("Shard channel write failed");
+            p += n;
+            size -= static_cast<std::size_t>(n);
+        }
+    }
+
+    // false — кінець потоку до першого байта (інший бік закрив канал)
+    bool readAll(void* data, std::size_t size) {
+        char* p = static_cast<char*>(data);
+        const std::size_t total = size;
+        while (size > 0) {
+            const ssize_t n = ::read(fd_, p, size);
+            if (n < 0 && errno == EINTR) continue;
+            if (n == 0 && size == total) return false;
+            if (n <= 0) throw std::runtime_error("Shard channel read failed");
+            p += n;
+            size -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+public:
+    ShardChannel(int fd, pid_t worker) : fd_(fd), worker_(worker) {}
+    ShardChannel(ShardChannel&& o) noexcept
+        : fd_(std::exchange(o.fd_, -1)), worker_(std::exchange(o.worker_, -1)) {}
+    ShardChannel& operator=(ShardChannel&& o) noexcept {
+        std::swap(fd_, o.fd_);
+        std::swap(worker_, o.worker_);
+        return *this;
+    }
+    ShardChannel(const ShardChannel&) = delete;
+    ShardChannel& operator=(const ShardChannel&) = delete;
+    ~ShardChannel() { close(); }
+
+    pid_t worker() const { return worker_; }
+
+    void close() {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+        if (worker_ > 0) {
+            while (::waitpid(worker_, nullptr, 0) < 0 && errno == EINTR) {}
+            worker_ = -1;
+        }
+    }
+
+    // (М74)
+    void send(ShardMessage type, const WireBuffer& body) {
+        const Header h{type, 0, body.bytes.size()};
+        writeAll(&h, sizeof(h));
+        writeAll(body.bytes.data(), body.bytes.size());
+    }
+
+    // false — інший бік закрив канал між повідомленнями
+    bool receive(ShardMessage& type, WireBuffer& body) {
+        Header h;
+        if (!readAll(&h, sizeof(h))) return false;
+        type = h.type;
+        body.bytes.resize(h.size);
+        body.pos = 0;
+        if (h.size > 0 && !readAll(body.bytes.data(), h.size))
+            throw std::runtime_error("Shard channel read failed");
+        return true;
+    }
+
+    WireBuffer expect(ShardMessage type) {
+        ShardMessage got{};
+        WireBuffer body;
+        if (!receive(got, body)) throw std::runtime_error("Shard channel closed");
+        if (got != type) throw std::runtime_error("Unexpected shard message");
+        return body;
+    }
+};
+
+class ShardedSimulator {
+    static constexpr double inf = std::numeric_limits<double>::infinity();
+
+    std::vector<std::string>               names_;     // глобальний ID -> ім'я (для inject)
+    PartitionResult                        partition_; // part: глобальний ID -> шард
+    double                                 lookahead_ = inf;
+    std::vector<std::vector<ShardPacket>>  pending_;   // пакети до запуску, по шардах
+    ShardedRunStats                        stats_;
+    std::vector<ShardChannel>              workers_;   // workers_[s] — процес шарда s
+
+    struct Event {
+        double        time;
+        std::uint32_t slot; // індекс у пулі пакетів шарда
+        bool operator>(const Event& o) const {
+            return time != o.time ? time > o.time : slot > o.slot;
+        }
+    };
+
+    // стан одного шарда (існує лише в його воркері)
+    struct ShardState {
+        std::vector<ShardPacket>   pool;
+        std::vector<std::uint32_t> freeSlots;
+        std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+        std::vector<ShardedPacketResult> results;
+
+        void schedule(ShardPacket&& p) {
+            std::uint32_t slot;
+            if (!freeSlots.empty()) { slot = freeSlots.back(); freeSlots.pop_back(); pool[slot] = std::move(p); }
+            else { slot = static_cast<std::uint32_t>(pool.size()); pool.push_back(std::move(p)); }
+            events.push({pool[slot].timeSeconds, slot});
+        }
+    };
+
+    static void writePackets(WireBuffer& out, const std::vector<ShardPacket>& packets) {
+        out.put<std::uint64_t>(packets.size());
+        for (const ShardPacket& p : packets) p.write(out);
+    }
+
+    static std::vector<ShardPacket> readPackets(WireBuffer& in) {
+        std::vector<ShardPacket> packets(in.get<std::uint64_t>());
+        for (ShardPacket& p : packets) p = ShardPacket::read(in);
+        return packets;
+    }
+
+    // (М64) [Packets] -> Min -> Window -> обробка до горизонту -> Outbox -> [Packets] ... -> Stop
+    static void runShard(const ShardTopology& topo, ShardChannel& coordinator, WireBuffer& msg) {
+        ShardState st;
+        for (;;) {
+            for (auto& p : readPackets(msg)) st.schedule(std::move(p));
+            WireBuffer min;
+            min.put(st.events.empty() ? inf : st.events.top().time);
+            coordinator.send(ShardMessage::Min, min);
+
+            ShardMessage type{};
+            if (!coordinator.receive(type, msg)) throw std::runtime_error("Shard channel closed");
+            if (type == ShardMessage::Stop) {
+                WireBuffer results;
+                results.putVector(st.results);
+                coordinator.send(ShardMessage::Results, results);
+                return;
+            }
+            if (type != ShardMessage::Window) throw std::runtime_error("Unexpected shard message");
+            const double globalMin = msg.get<double>();
+            const double horizon = msg.get<double>();
+
+            std::vector<ShardPacket> outbox;
+            while (!st.events.empty()) {
+                const Event ev = st.events.top();
+                if (!(ev.time < horizon || ev.time <= globalMin)) break; // L == 0: лише поточна мить
+                st.events.pop();
+                ShardPacket& p = st.pool[ev.slot];
+
+                if (p.hop + 1 >= p.path.size() || p.ttl <= 0) {
+                    st.results.push_back({p.id, p.timeSeconds - p.startSeconds, p.ttl, p.hop,
+                                          p.hop + 1 >= p.path.size()});
+                    st.freeSlots.push_back(ev.slot);
+                    continue;
+                }
+                const std::uint32_t u = p.path[p.hop], v = p.path[p.hop + 1];
+                p.timeSeconds += topo.hopCost(u, v, p.sizeBytes);
+                p.ttl -= 1;
+                p.hop += 1;
+                if (topo.owns(v)) {
+                    st.events.push({p.timeSeconds, ev.slot});
+                } else {
+                    outbox.push_back(std::move(p));
+                    st.freeSlots.push_back(ev.slot);
+                }
+            }
+            WireBuffer out;
+            writePackets(out, outbox);
+            coordinator.send(ShardMessage::Outbox, out);
+            msg = coordinator.expect(ShardMessage::Packets);
+        }
+    }
+
+    // тіло воркера: отримати свій шард, далі — запуски, доки координатор не закриє канал
+    static void workerMain(ShardChannel& coordinator) {
+        WireBuffer msg = coordinator.expect(ShardMessage::Topology);
+        const ShardTopology topo = ShardTopology::read(msg);
+        ShardMessage type{};
+        while (coordinator.receive(type, msg)) {
+            if (type == ShardMessage::Shutdown) return;
+            if (type != ShardMessage::Packets) throw std::runtime_error("Unexpected shard message");
+            runShard(topo, coordinator, msg);
+        }
+    }
+
+    // у воркері: свій сокет -> fd 3, усе інше після stderr закрити. Інакше воркер утримував би
+    // координаторські кінці каналів інших ShardedSimulator, і їхні воркери не бачили б EOF
+    static int closeInheritedFds(int own) {
+        constexpr int kept = 3;
+        if (own != kept) {
+            if (::dup2(own, kept) < 0) ::_exit(1);
+        }
+#if defined(__linux__) && defined(SYS_close_range)
+        if (::syscall(SYS_close_range, kept + 1u, ~0u, 0u) == 0) return kept;
+#endif
+        const long maxFd = ::sysconf(_SC_OPEN_MAX);
+        for (long fd = kept + 1; fd < (maxFd > 0 ? maxFd : 1024); ++fd) ::close(static_cast<int>(fd));
+        return kept;
+    }
+
+    void spawnWorker() {
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+            throw std::runtime_error("socketpair() failed");
+        const pid_t pid = ::fork();
+        if (pid < 0) {
+            ::close(fds[0]);
+            ::close(fds[1]);
+            throw std::runtime_error("fork() failed");
+        }
+        if (pid == 0) { // воркер: лише свій кінець каналу; деструктори батька не виконуються (_exit)
+            const int own = closeInheritedFds(fds[1]);
+            int status = 0;
+            try {
+                ShardChannel coordinator(own, -1);
+                workerMain(coordinator);
+            } catch (...) {
+                status = 1;
+            }
+            ::_exit(status);
+        }
+        ::close(fds[1]);
+        workers_.emplace_back(fds[0], pid);
+    }
+
+public:
+    // (М61) спершу воркери, потім розбиття і розсилка шардів
+    ShardedSimulator(const LinkArrays& links, std::uint32_t shards, double imbalance = 0.03) {
+        if (shards == 0) throw std::runtime_error("GraphPartitioner: parts must be > 0");
+        for (std::uint32_t s = 0; s < shards; ++s) spawnWorker();
+
+        partition_ = GraphPartitioner(shards, imbalance)
+                         .partition(UndirectedCsr::fromDirected(links.topo));
+        names_ = links.topo.nodes;
+        pending_.resize(shards);
+        const std::vector<std::uint32_t>& owner = partition_.part;
+
+        for (std::uint32_t s = 0; s < shards; ++s) {
+            WireBuffer msg;
+            ShardTopology::extract(links, owner, s).write(msg);
+            workers_[s].send(ShardMessage::Topology, msg);
+        }
+
+        for (std::uint32_t u = 0; u < owner.size(); ++u)
+            for (std::uint32_t e = links.topo.offsets[u]; e < links.topo.offsets[u + 1]; ++e)
+                if (owner[links.topo.targets[e]] != owner[u])
+                    lookahead_ = std::min(lookahead_, links.baseSeconds[e]);
+    }
+
+    ShardedSimulator(const Graph<std::string, Link>& g, std::uint32_t shards, double imbalance = 0.03)
+        : ShardedSimulator(LinkArrays::fromGraph(g), shards, imbalance) {}
+
+    ShardedSimulator(const ShardedSimulator&) = delete;
+    ShardedSimulator& operator=(const ShardedSimulator&) = delete;
+
+    // явний Shutdown, потім workers_ закривають канали й чекають на процеси
+    ~ShardedSimulator() {
+        for (auto& w : workers_) {
+            try { w.send(ShardMessage::Shutdown, WireBuffer{}); } catch (...) {} // воркер уже завершився
+        }
+    }
+
+    std::uint32_t shardCount() const { return static_cast<std::uint32_t>(workers_.size()); }
+    const PartitionResult& partition() const { return partition_; }
+    pid_t workerPid(std::uint32_t s) const { return workers_[s].worker(); }
+    double lookahead() const { return lookahead_; }
+    const ShardedRunStats& lastRunStats() const { return stats_; }
+
+    std::uint32_t shardOf(const std::string& node) const {
+        auto it = std::lower_bound(names_.begin(), names_.end(), node);
+        if (it == names_.end() || *it != node) throw std::runtime_error("Unknown node in ShardedSimulator");
+        return partition_.part[it - names_.begin()];
+    }
+
+    // (М62) path — маршрут з іменами вузлів (наприклад, з findRoute)
+    void inject(std::uint32_t id, const std::vector<std::string>& path, std::size_t sizeBytes,
+                int ttl = 8, double startSeconds = 0.0)
+    {
+        ShardPacket p;
+        p.id = id;
+        p.ttl = ttl;
+        p.sizeBytes = sizeBytes;
+        p.startSeconds = p.timeSeconds = startSeconds;
+        for (auto& name : path) {
+            auto it = std::lower_bound(names_.begin(), names_.end(), name);
+            if (it == names_.end() || *it != name) throw std::runtime_error("Unknown node in ShardedSimulator");
+            p.path.push_back(static_cast<std::uint32_t>(it - names_.begin()));
+        }
+        if (p.path.empty()) throw std::runtime_error("Empty path in ShardedSimulator::inject");
+        pending_[partition_.part[p.path.front()]].push_back(std::move(p));
+    }
+
+    // (М63) результати — за зростанням id; черги інжекції після запуску порожні
+    std::vector<ShardedPacketResult> run() {
+        const std::uint32_t n = shardCount();
+        for (std::uint32_t s = 0; s < n; ++s) {
+            WireBuffer msg;
+            writePackets(msg, std::exchange(pending_[s], {}));
+            workers_[s].send(ShardMessage::Packets, msg);
+        }
+
+        stats_ = ShardedRunStats{};
+        std::vector<std::vector<ShardPacket>> inbox(n);
+        for (;;) {
+            double globalMin = inf;
+            for (auto& w : workers_) globalMin = std::min(globalMin, w.expect(ShardMessage::Min).get<double>());
+            if (globalMin == inf) break; // подій немає ні в кого, а граничні пакети вже доставлено
+            ++stats_.rounds;
+
+            WireBuffer window;
+            window.put(globalMin);
+            window.put(globalMin + lookahead_);
+            for (auto& w : workers_) w.send(ShardMessage::Window, window);
+
+            for (auto& w : workers_) {
+                WireBuffer msg = w.expect(ShardMessage::Outbox);
+                for (auto& p : readPackets(msg)) {
+                    inbox[partition_.part[p.path[p.hop]]].push_back(std::move(p));
+                    ++stats_.crossShardMessages;
+                }
+            }
+            for (std::uint32_t s = 0; s < n; ++s) {
+                WireBuffer msg;
+                writePackets(msg, std::exchange(inbox[s], {}));
+                workers_[s].send(ShardMessage::Packets, msg);
+            }
+        }
+
+        std::vector<ShardedPacketResult> results;
+        for (auto& w : workers_) {
+            w.send(ShardMessage::Stop, WireBuffer{});
+            WireBuffer msg = w.expect(ShardMessage::Results);
+            auto part = msg.getVector<ShardedPacketResult>();
+            results.insert(results.end(), part.begin(), part.end());
+        }
+        std::sort(results.begin(), results.end(),
+                  [](const ShardedPacketResult& a, const ShardedPacketResult& b) { return a.id < b.id; });
+        return results;
+    }
+};
+
+#endif // defined(__unix__) || defined(__APPLE__)
+
+#endif //SHARDEDSIMULATION_H
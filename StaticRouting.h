@@ -0,0 +1,158 @@
+#ifndef STATICROUTING_H
+#define STATICROUTING_H
+
+/*
+КЛАСИ/ТИПИ У ФАЙЛІ:
+ 20) struct TransferTimeCost / LatencyCost / HopCountCost - функції вартості ребра
+ 21) concept LinkGraph - граф з ребрами Link (Graph<std::string, Link> або сумісний)
+ 22) concept StaticRoutingAlgorithm - статичний інтерфейс алгоритму маршрутизації
+ 23) template<class CostFn> class StaticDijkstraRouting - Дейкстра без віртуальних викликів
+
+ПОЛЯ:
+  - StaticDijkstraRouting: cost_, names_, adj_, dist_, parent_, heap_ - 6
+  разом: 6
+
+НЕТРИВІАЛЬНІ МЕТОДИ:
+  (М38) StaticDijkstraRouting::route(g, src, dst, bytes, out) - маршрут у буфер викликача
+  (М39) StaticDijkstraRouting::indexOf(name) - щільний індекс вершини (бінарний пошук)
+  разом: 2
+
+ПРИМІТКИ:
+  - статичний поліморфізм замість RoutingAlgorithm: функція вартості (CostFn) і тип графа (G)
+    підставляються під час компіляції, тож costForBytes вбудовується в цикл релаксації;
+  - немає тимчасового графа WeightedEdge: Дейкстра працює прямо по Link;
+  - робочі масиви (dist_, parent_, heap_) живуть в об'єкті алгоритму і перевикористовуються,
+    результат пишеться у переданий вектор — у сталому режимі виклик не виділяє пам'ять;
+  - результат збігається з DijkstraRouting (той самий порядок рівних відстаней: за іменем вершини).
+*/
+
+#include "Graph.h"
+#include "Network.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+// вартість = час передачі payload (як у DijkstraRouting)
+struct TransferTimeCost {
+    double operator()(const Link& link, std::size_t payloadBytes) const {
+        return link.costForBytes(payloadBytes);
+    }
+};
+
+// вартість = лише затримка каналу (секунди), розмір пакета ігнорується
+struct LatencyCost {
+    double operator()(const Link& link, std::size_t) const { return link.latencyMs / 1000.0; }
+};
+
+// вартість = кількість хопів
+struct HopCountCost {
+    double operator()(const Link&, std::size_t) const { return 1.0; }
+};
+
+// граф, у якого data() — впорядкована мапа: ім'я -> вектор (сусід, Link)
+template <typename G>
+concept LinkGraph = requires(const G& g) {
+    { g.data().begin()->first } -> std::convertible_to<const std::string&>;
+    { g.data().begin()->second.begin()->second } -> std::convertible_to<const Link&>;
+};
+
+// статичний інтерфейс: маршрут пишеться в out, результат — чи знайдено шлях
+template <typename A>
+concept StaticRoutingAlgorithm = requires(A& algo,
+                                          const Graph<std::string, Link>& g,
+                                          const std::string& node,
+                                          std::size_t payloadBytes,
+                                          std::vector<std::string>& out) {
+    { algo.route(g, node, node, payloadBytes, out) } -> std::same_as<bool>;
+};
+
+template <typename CostFn = TransferTimeCost>
+class StaticDijkstraRouting {
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+    using Adjacency = std::vector<std::pair<std::string, Link>>;
+    using HeapItem = std::pair<double, std::uint32_t>;
+
+    [[no_unique_address]] CostFn cost_;
+    // робочі буфери (перевикористовуються між викликами)
+    std::vector<const std::string*> names_; // індекс -> ім'я (у порядку мапи, тобто відсортовано)
+    std::vector<const Adjacency*>   adj_;   // індекс -> список суміжності
+    std::vector<double>             dist_;
+    std::vector<std::uint32_t>      parent_;
+    std::vector<HeapItem>           heap_;
+
+    // (М39) бінарний пошук по відсортованих іменах
+    std::uint32_t indexOf(const std::string& name) const {
+        auto it = std::lower_bound(names_.begin(), names_.end(), name,
+            [](const std::string* a, const std::string& b) { return *a < b; });
+        if (it == names_.end() || **it != name) return npos;
+        return static_cast<std::uint32_t>(it - names_.begin());
+    }
+
+public:
+    explicit StaticDijkstraRouting(CostFn cost = CostFn{}) : cost_(cost) {}
+
+    // (М38) Дейкстра прямо по Link з ранньою зупинкою на dst; шлях src..dst -> out
+    template <LinkGraph G>
+    bool route(const G& g, const std::string& src, const std::string& dst,
+               std::size_t payloadBytes, std::vector<std::string>& out)
+    {
+        names_.clear(); adj_.clear();
+        for (auto& [u, vec] : g.data()) { names_.push_back(&u); adj_.push_back(&vec); }
+
+        const std::uint32_t s = indexOf(src), t = indexOf(dst);
+        if (s == npos || t == npos) { out.clear(); return false; }
+
+        dist_.assign(names_.size(), std::numeric_limits<double>::infinity());
+        parent_.assign(names_.size(), npos);
+        heap_.clear();
+
+        auto cmp = std::greater<HeapItem>{}; // мін-купа
+        dist_[s] = 0.0;
+        heap_.push_back({0.0, s});
+        NETSIM_METRIC_ADD(HeapPushes, 1);
+
+        while (!heap_.empty()) {
+            std::pop_heap(heap_.begin(), heap_.end(), cmp);
+            auto [du, u] = heap_.back(); heap_.pop_back();
+            if (du != dist_[u]) { // застарілий елемент
+                NETSIM_METRIC_ADD(StalePops, 1);
+                continue;
+            }
+            NETSIM_METRIC_ADD(VerticesSettled, 1);
+            if (u == t) break; // відстань до dst остаточна
+
+            NETSIM_METRIC_ADD(EdgesRelaxed, adj_[u]->size());
+            for (auto& [vName, link] : *adj_[u]) {
+                std::uint32_t v = indexOf(vName);
+                double nd = du + cost_(link, payloadBytes);
+                if (nd < dist_[v]) { // релаксація
+                    dist_[v] = nd;
+                    parent_[v] = u;
+                    heap_.push_back({nd, v});
+                    std::push_heap(heap_.begin(), heap_.end(), cmp);
+                    NETSIM_METRIC_ADD(HeapPushes, 1);
+                }
+            }
+        }
+
+        if (dist_[t] == std::numeric_limits<double>::infinity()) { out.clear(); return false; }
+
+        // довжина шляху, потім заповнення з кінця (рядки в out перевикористовують свою пам'ять)
+        std::size_t len = 1;
+        for (std::uint32_t cur = t; cur != s; cur = parent_[cur]) ++len;
+        out.resize(len);
+        std::size_t i = len;
+        for (std::uint32_t cur = t; ; cur = parent_[cur]) {
+            out[--i] = *names_[cur];
+            if (cur == s) break;
+        }
+        return true;
+    }
+};
+
+#endif //STATICROUTING_H
@@ -4,6 +4,16 @@
 #include "../GraphAlgorithms.h"
 #include "../Network.h"
 #include "../NetworkSimulator.h"
+#include "../Metrics.h"
+#include "../PacketTrace.h"
+
+#include <filesystem>
+
+#include <atomic>
+#include <thread>
+#ifdef NETSIM_HAS_PROCESS_SHARDS
+#include <signal.h>
+#endif
 
 // ---------- Hierarchy / polymorphism tests ----------
 TEST(HierarchyTest, KindAndDynamicCast) {
@@ -71,3 +81,634 @@ TEST(NetworkSimulatorTest, BuildDemoRouteAndSend) {
     EXPECT_GT(t, 0.0);
     EXPECT_LT(pkt.ttl(), 8); // TTL зменшився
 }
+
+// ---------- Concurrency: copy-on-write topology snapshots ----------
+TEST(NetworkSimulatorTest, SnapshotIsImmutableAfterPublish) {
+    NetworkSimulator sim;
+    sim.buildDemo();
+
+    TopologySnapshot before = sim.snapshot();
+    sim.addDevice(new Host(5, "H3", "10.0.0.3"));
+    sim.connect("S1", "H3", Link{0.2, 1000.0, 0.999});
+
+    // стара версія не змінюється, нова містить оновлення
+    EXPECT_FALSE(before->hasNode("H3"));
+    EXPECT_TRUE(sim.snapshot()->hasNode("H3"));
+    EXPECT_EQ(sim.snapshot()->size(), before->size() + 1);
+}
+
+TEST(NetworkSimulatorTest, BatchedUpdateBuildsGridWithOnePublish) {
+    NetworkSimulator sim;
+    TopologySnapshot empty = sim.snapshot();
+    const int side = 100; // 10k вузлів, 19 800 викликів connect
+    auto name = [](int r, int c) { return "N" + std::to_string(r) + "_" + std::to_string(c); };
+
+    TopologySnapshot seenInside;
+    sim.update([&](NetworkSimulator::TopologyEditor& t) {
+        int id = 1;
+        for (int r = 0; r < side; ++r)
+            for (int c = 0; c < side; ++c) t.addDevice(new Router(id++, name(r, c)));
+        for (int r = 0; r < side; ++r) {
+            for (int c = 0; c < side; ++c) {
+                if (c + 1 < side) t.connect(name(r, c), name(r, c + 1), Link{0.1, 100.0, 0.999});
+                if (r + 1 < side) t.connect(name(r, c), name(r + 1, c), Link{0.1, 100.0, 0.999});
+            }
+        }
+        seenInside = sim.snapshot(); // читачі не бачать напівпобудованої топології
+    });
+
+    EXPECT_EQ(seenInside, empty);
+    TopologySnapshot g = sim.snapshot();
+    ASSERT_EQ(g->size(), std::size_t(side * side));
+    std::size_t edges = 0;
+    for (auto& [u, vec] : g->data()) edges += vec.size();
+    EXPECT_EQ(edges, std::size_t(4 * side * (side - 1)));
+
+    std::vector<std::string> route;
+    ASSERT_TRUE(sim.findRoute("N0_0", name(side - 1, side - 1), 1500, route));
+    EXPECT_EQ(route.size(), std::size_t(2 * side - 1));
+
+    // виняток посеред пакета: все або нічого — ні публікації, ні змін у робочій копії
+    EXPECT_THROW(sim.update([](NetworkSimulator::TopologyEditor& t) {
+        t.addDevice(new Host(20000, "HX", "10.0.0.9"));
+        t.connect("HX", "N0_0", Link{1.0, 10.0, 0.9});
+        t.connect("HX", "missing", Link{1.0, 10.0, 0.9});
+    }), std::runtime_error);
+    EXPECT_EQ(sim.snapshot(), g);
+    EXPECT_FALSE(sim.snapshot()->hasNode("HX"));
+
+    // наступний писач публікує стан без залишків невдалого пакета
+    sim.connect("N0_0", "N0_1", Link{0.1, 100.0, 0.999});
+    EXPECT_FALSE(sim.snapshot()->hasNode("HX"));
+    EXPECT_EQ(sim.snapshot()->size(), std::size_t(side * side));
+}
+
+TEST(NetworkSimulatorTest, FailedLoadKeepsPreviousTopology) {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto good = (dir / "netsim_topology_ok.txt").string();
+    const auto bad = (dir / "netsim_topology_bad.txt").string();
+    {
+        NetworkSimulator demo;
+        demo.buildDemo();
+        demo.saveTopology(good);
+    }
+    {
+        std::ofstream out(bad);
+        out << "NODES:\n A Router\n B Host\nEDGES:\n A B 1 100 0.99\n A Z 1 100 0.99\n";
+    }
+
+    NetworkSimulator sim;
+    sim.loadTopology(good);
+    TopologySnapshot loaded = sim.snapshot();
+    ASSERT_EQ(loaded->size(), 4u);
+
+    EXPECT_THROW(sim.loadTopology(bad), std::runtime_error);
+    EXPECT_EQ(sim.snapshot(), loaded);
+
+    // наступний писач публікує стару топологію + свою зміну, а не напівзавантажений файл
+    sim.connect("H1", "H2", Link{0.1, 1000.0, 0.999});
+    TopologySnapshot g = sim.snapshot();
+    EXPECT_EQ(g->size(), 4u);
+    EXPECT_FALSE(g->hasNode("A"));
+    std::vector<std::string> route;
+    ASSERT_TRUE(sim.findRoute("H1", "H2", 1500, route));
+    EXPECT_EQ(route, (std::vector<std::string>{"H1", "H2"}));
+
+    std::filesystem::remove(good);
+    std::filesystem::remove(bad);
+}
+
+TEST(NetworkSimulatorTest, ConcurrentRoutingDuringTopologyUpdates) {
+    NetworkSimulator sim;
+    sim.buildDemo();
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            DijkstraRouting algo;
+            while (!stop.load()) {
+                TopologySnapshot g = sim.snapshot();
+                auto route = algo.route(*g, "H1", "H2", 1500);
+                Packet pkt("H1", "H2", 8, 1500);
+                // H1 -> S1 -> R1 -> H2 існує в кожній версії
+                if (route.size() < 3 || sim.sendPacket(*g, route, pkt) <= 0.0) ++failures;
+            }
+        });
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        std::string name = "X" + std::to_string(i);
+        sim.addDevice(new Switch(100 + i, name));
+        sim.connect("R1", name, Link{0.1, 1000.0, 0.999});
+    }
+    stop = true;
+    for (auto& th : readers) th.join();
+
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(sim.snapshot()->size(), 4u + 200u);
+}
+
+// ---------- Hot-path metrics ----------
+TEST(MetricsTest, DijkstraCountersAndExport) {
+    ASSERT_TRUE(kMetricsEnabled); // tests/CMakeLists.txt вмикає NETSIM_METRICS
+
+    Graph<std::string, WeightedEdge> wg(true);
+    wg.addEdge("A","B", WeightedEdge{5.0});
+    wg.addEdge("B","C", WeightedEdge{2.0});
+    wg.addEdge("A","C", WeightedEdge{9.0});
+
+    MetricsRegistry::instance().reset();
+    Dijkstra<std::string> dj;
+    dj.run(wg, "A");
+    MetricsSnapshot m = MetricsRegistry::instance().snapshot();
+
+    // A (push 0), B (push 5), C (push 9), C (push 7); C=9 знімається як застарілий
+    EXPECT_EQ(m[Metric::VerticesSettled], 3u);
+    EXPECT_EQ(m[Metric::EdgesRelaxed], 3u);
+    EXPECT_EQ(m[Metric::HeapPushes], 4u);
+    EXPECT_EQ(m[Metric::StalePops], 1u);
+
+    EXPECT_NE(m.toJson().find("\"dijkstra_vertices_settled_total\": 3"), std::string::npos);
+    EXPECT_NE(m.toPrometheus().find("netsim_dijkstra_stale_pops_total 1\n"), std::string::npos);
+}
+
+TEST(MetricsTest, SimulatorCountersIncludeFinishedThreads) {
+    NetworkSimulator sim;
+    sim.buildDemo();
+    MetricsRegistry::instance().reset();
+
+    std::thread worker([&] {
+        DijkstraRouting algo;
+        Packet pkt("H1", "H2", 8, 1500);
+        auto route = sim.findRoute(algo, "H1", "H2", pkt.size());
+        sim.sendPacket(route, pkt);
+    });
+    worker.join(); // буфер потоку переноситься у реєстр при завершенні
+
+    MetricsSnapshot m = MetricsRegistry::instance().snapshot();
+    EXPECT_EQ(m[Metric::HopsSimulated], 3u); // H1 -> S1 -> R1 -> H2
+    EXPECT_GT(m[Metric::VerticesSettled], 0u);
+    EXPECT_GT(m[Metric::WeightedGraphBuildNs], 0u);
+}
+
+// ---------- Static (compile-time) routing dispatch ----------
+TEST(StaticRoutingTest, MatchesDynamicDijkstraRouting) {
+    NetworkSimulator sim;
+    sim.buildDemo();
+    sim.addDevice(new Host(5, "H3", "10.0.0.3"));
+    sim.connect("S1", "H3", Link{0.2, 10.0, 0.999});
+    sim.connect("H3", "H2", Link{0.1, 10.0, 0.999});
+
+    DijkstraRouting dynamicAlgo;
+    std::vector<std::string> out;
+    const char* names[] = {"R1", "S1", "H1", "H2", "H3"};
+    for (std::size_t bytes : {64u, 1500u, 1'000'000u}) {
+        for (auto* a : names) {
+            for (auto* b : names) {
+                auto expected = sim.findRoute(dynamicAlgo, a, b, bytes);
+                bool found = sim.findRoute<StaticDijkstraRouting<>>(a, b, bytes, out);
+                EXPECT_EQ(found, !expected.empty());
+                EXPECT_EQ(out, expected) << a << " -> " << b << " @ " << bytes;
+            }
+        }
+    }
+}
+
+TEST(StaticRoutingTest, CostFunctionAndMissingNodes) {
+    NetworkSimulator sim;
+    sim.buildDemo();
+    sim.connect("H1", "H2", Link{50.0, 1.0, 0.9}); // прямий, але дуже повільний канал
+
+    std::vector<std::string> out;
+    StaticDijkstraRouting<HopCountCost> byHops;
+    ASSERT_TRUE(sim.findRoute(byHops, "H1", "H2", 1500, out));
+    EXPECT_EQ(out, (std::vector<std::string>{"H1", "H2"}));
+
+    ASSERT_TRUE(sim.findRoute<StaticDijkstraRouting<>>("H1", "H2", 1500, out));
+    EXPECT_EQ(out, (std::vector<std::string>{"H1", "S1", "R1", "H2"}));
+
+    EXPECT_FALSE(sim.findRoute<StaticDijkstraRouting<>>("H1", "nope", 1500, out));
+    EXPECT_TRUE(out.empty());
+}
+
+// ---------- Payload sweeps (SoA links + multi-payload Dijkstra) ----------
+TEST(PayloadSweepTest, KernelMatchesScalarCost) {
+    Graph<std::string, Link> g(true);
+    g.addEdge("A", "B", Link{0.5, 100.0, 0.999});
+    g.addEdge("A", "C", Link{3.0, 20.0, 0.98});
+    g.addEdge("B", "C", Link{1.0, 0.0, 0.5}); // bandwidth 0 — "нескінченний" час
+    g.addEdge("C", "A", Link{0.0, 1.0, 1.0});
+    g.addEdge("C", "B", Link{7.0, 10000.0, 0.9});
+
+    LinkArrays links = LinkArrays::fromGraph(g);
+    ASSERT_EQ(links.edgeCount(), 5u);
+    std::vector<std::size_t> payloads{0, 64, 1500, 9000, 1'000'000};
+    std::vector<double> costs(payloads.size() * links.edgeCount());
+    linkCostsForPayloads(links, payloads.data(), payloads.size(), costs.data());
+
+    for (std::size_t j = 0; j < payloads.size(); ++j)
+        for (std::size_t e = 0; e < links.edgeCount(); ++e)
+            EXPECT_EQ(costs[j * links.edgeCount() + e], links.link(e).costForBytes(payloads[j]));
+}
+
+TEST(PayloadSweepTest, MatchesPerPayloadRouting) {
+    NetworkSimulator sim;
+    sim.addDevice(new Host(1, "H1", "10.0.0.1"));
+    sim.addDevice(new Host(2, "H2", "10.0.0.2"));
+    sim.addDevice(new Router(3, "FAST_LAT"));
+    sim.addDevice(new Router(4, "FAST_BW"));
+    // малі пакети — через низьку затримку, великі — через широкий канал
+    sim.connect("H1", "FAST_LAT", Link{0.1, 1.0, 0.999});
+    sim.connect("FAST_LAT", "H2", Link{0.1, 1.0, 0.999});
+    sim.connect("H1", "FAST_BW", Link{5.0, 1000.0, 0.999});
+    sim.connect("FAST_BW", "H2", Link{5.0, 1000.0, 0.999});
+
+    std::vector<std::size_t> payloads{64, 512, 1500, 9000, 100'000, 1'000'000};
+    auto routes = sim.findRoutes("H1", "H2", payloads);
+    ASSERT_EQ(routes.size(), payloads.size());
+
+    DijkstraRouting algo;
+    for (std::size_t j = 0; j < payloads.size(); ++j)
+        EXPECT_EQ(routes[j], sim.findRoute(algo, "H1", "H2", payloads[j])) << payloads[j];
+    EXPECT_EQ(routes.front()[1], "FAST_LAT");
+    EXPECT_EQ(routes.back()[1], "FAST_BW");
+
+    auto none = sim.findRoutes("H1", "missing", payloads);
+    ASSERT_EQ(none.size(), payloads.size());
+    EXPECT_TRUE(none[0].empty());
+
+    // SoA-масиви кешуються на версію: без публікацій — той самий об'єкт, після connect — новий
+    std::shared_ptr<const LinkArrays> cached = sim.linkArrays();
+    EXPECT_EQ(sim.linkArrays(), cached);
+    EXPECT_EQ(cached->edgeCount(), 8u);
+    sim.connect("H1", "H2", Link{50.0, 1.0, 0.9});
+    EXPECT_NE(sim.linkArrays(), cached);
+    EXPECT_EQ(sim.linkArrays()->edgeCount(), 10u);
+    EXPECT_EQ(cached->edgeCount(), 8u);
+}
+
+// ---------- Connectivity: SCC, articulation points, bridges ----------
+TEST(ConnectivityTest, TarjanStronglyConnectedComponents) {
+    Graph<int, int> g(true);
+    // {1,2,3} — цикл, {4,5} — цикл, 3 -> 4 зв'язує їх в один бік, 6 — окремо
+    g.addEdge(1, 2, 0); g.addEdge(2, 3, 0); g.addEdge(3, 1, 0);
+    g.addEdge(3, 4, 0); g.addEdge(4, 5, 0); g.addEdge(5, 4, 0);
+    g.addNode(6);
+
+    auto sccs = stronglyConnectedComponents(g);
+    ASSERT_EQ(sccs.size(), 3u);
+    for (auto& c : sccs) std::sort(c.begin(), c.end());
+    std::sort(sccs.begin(), sccs.end());
+    EXPECT_EQ(sccs[0], (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(sccs[1], (std::vector<int>{4, 5}));
+    EXPECT_EQ(sccs[2], (std::vector<int>{6}));
+}
+
+TEST(ConnectivityTest, SinglePointsOfFailureInDemoTopology) {
+    NetworkSimulator sim;
+    sim.buildDemo(); // H1 - S1 - R1 - H2: дерево, усі канали — мости
+
+    TopologyReport r = sim.analyzeTopology();
+    EXPECT_EQ(r.stronglyConnectedComponents, 1u);
+    EXPECT_EQ(r.articulationPoints, (std::vector<std::string>{"R1", "S1"}));
+    ASSERT_EQ(r.bridges.size(), 3u);
+    EXPECT_EQ(r.bridges[0], (std::pair<std::string, std::string>{"H1", "S1"}));
+
+    // резервний канал H1 - H2 замикає кільце: точок відмови більше немає
+    sim.connect("H1", "H2", Link{5.0, 10.0, 0.9});
+    r = sim.analyzeTopology();
+    EXPECT_TRUE(r.articulationPoints.empty());
+    EXPECT_TRUE(r.bridges.empty());
+}
+
+TEST(ConnectivityTest, DoubledLinkIsNotABridge) {
+    NetworkSimulator sim;
+    sim.buildDemo();
+    sim.connect("R1", "H2", Link{2.0, 50.0, 0.99}); // другий незалежний канал R1 - H2
+
+    TopologyReport r = sim.analyzeTopology();
+    EXPECT_EQ(r.bridges, (std::vector<std::pair<std::string, std::string>>{{"H1", "S1"}, {"R1", "S1"}}));
+    EXPECT_EQ(r.articulationPoints, (std::vector<std::string>{"R1", "S1"})); // вузли — як і були
+
+    // один двосторонній канал (A->B і B->A) — кратність 1; два — кратність 2
+    DenseGraph<std::string> d = DenseGraph<std::string>::fromGraph(*sim.snapshot());
+    UndirectedCsr u = UndirectedCsr::fromDirected(d);
+    ASSERT_EQ(u.edgeCount, 3u);
+    std::vector<std::uint32_t> m = u.multiplicity;
+    std::sort(m.begin(), m.end());
+    EXPECT_EQ(m, (std::vector<std::uint32_t>{1, 1, 2}));
+
+    // паралельні односторонні канали: A->B двічі (або двосторонній + ще один A->B), B<->C
+    for (bool extraIsOneWay : {false, true}) {
+        Graph<std::string, Link> g(true);
+        for (auto n : {"A", "B", "C"}) g.addNode(n);
+        g.addEdge("A", "B", Link{1.0, 10.0, 0.9});
+        g.addEdge("A", "B", Link{2.0, 10.0, 0.9});
+        if (extraIsOneWay) g.addEdge("B", "A", Link{1.0, 10.0, 0.9});
+        g.addEdge("B", "C", Link{1.0, 10.0, 0.9});
+        g.addEdge("C", "B", Link{1.0, 10.0, 0.9});
+        EXPECT_EQ(bridges(g), (std::vector<std::pair<std::string, std::string>>{{"B", "C"}})) << extraIsOneWay;
+    }
+}
+
+TEST(ConnectivityTest, DeepChainWithoutRecursion) {
+    // ланцюжок 0 -> 1 -> ... -> n-1 -> 0: одна SCC, рекурсивний DFS переповнив би стек
+    const std::uint32_t n = 1'000'000;
+    DenseGraph<std::uint32_t> d;
+    d.nodes.resize(n);
+    d.offsets.resize(n + 1);
+    d.targets.resize(n);
+    for (std::uint32_t u = 0; u < n; ++u) {
+        d.nodes[u] = u;
+        d.offsets[u] = u;
+        d.targets[u] = (u + 1) % n;
+    }
+    d.offsets[n] = n;
+
+    EXPECT_EQ(stronglyConnectedComponents(d).count, 1u);
+    UndirectedCsr ring = UndirectedCsr::fromDirected(d);
+    EXPECT_TRUE(articulationPoints(ring).empty());
+    EXPECT_TRUE(bridges(ring).empty());
+
+    d.targets[n - 1] = n - 1; // розриваємо кільце: тепер це шлях (петля ігнорується)
+    EXPECT_EQ(stronglyConnectedComponents(d).count, n);
+    UndirectedCsr path = UndirectedCsr::fromDirected(d);
+    EXPECT_EQ(articulationPoints(path).size(), n - 2);
+    EXPECT_EQ(bridges(path).size(), n - 1);
+}
+
+// ---------- Partitioning + sharded simulation ----------
+namespace {
+// решітка side x side з двосторонніми каналами різної затримки
+void buildGrid(NetworkSimulator& sim, int side) {
+    auto name = [](int r, int c) { return "N" + std::to_string(r) + "_" + std::to_string(c); };
+    sim.update([&](NetworkSimulator::TopologyEditor& t) {
+        int id = 1;
+        for (int r = 0; r < side; ++r)
+            for (int c = 0; c < side; ++c) t.addDevice(new Router(id++, name(r, c)));
+        for (int r = 0; r < side; ++r) {
+            for (int c = 0; c < side; ++c) {
+                double lat = 0.1 + 0.05 * ((r * 7 + c * 3) % 5);
+                if (c + 1 < side) t.connect(name(r, c), name(r, c + 1), Link{lat, 100.0, 0.999});
+                if (r + 1 < side) t.connect(name(r, c), name(r + 1, c), Link{lat * 2, 1000.0, 0.999});
+            }
+        }
+    });
+}
+}
+
+TEST(PartitionTest, BalancedWithSmallEdgeCut) {
+    NetworkSimulator sim;
+    buildGrid(sim, 32); // 1024 вузли, 1984 канали
+
+    PartitionResult p = GraphPartitioner(4).partition(*sim.snapshot());
+    ASSERT_EQ(p.part.size(), 1024u);
+    for (auto w : p.partWeights) {
+        EXPECT_GT(w, 0u);
+        EXPECT_LE(w, 264u); // ceil(1.03 * 1024 / 4)
+    }
+    // оптимум для решітки 32x32 на 4 частини — 64 ребра; довільне розбиття дало б ~1500
+    EXPECT_LE(p.edgeCut, 160u);
+
+    PartitionResult single = GraphPartitioner(1).partition(*sim.snapshot());
+    EXPECT_EQ(single.edgeCut, 0u);
+}
+
+#ifdef NETSIM_HAS_PROCESS_SHARDS
+TEST(ShardedSimulationTest, MatchesSequentialSendPacket) {
+    NetworkSimulator sim;
+    buildGrid(sim, 12);
+    ShardedSimulator sharded = sim.shard(4);
+    EXPECT_GT(sharded.lookahead(), 0.0);
+
+    DijkstraRouting algo;
+    std::vector<std::pair<double, int>> expected; // (час, TTL) з послідовної симуляції
+    std::vector<std::uint32_t> expectedHops;
+    std::uint32_t id = 0;
+    for (int i = 0; i < 12; ++i) {
+        std::string src = "N0_" + std::to_string(i), dst = "N11_" + std::to_string(11 - i);
+        int ttl = (i == 3) ? 5 : 64; // один пакет вичерпає TTL по дорозі
+        auto route = sim.findRoute(algo, src, dst, 1500);
+        Packet pkt(src, dst, ttl, 1500);
+        expected.push_back({sim.sendPacket(route, pkt), pkt.ttl()});
+        expectedHops.push_back(static_cast<std::uint32_t>(pkt.hops().size() - 1));
+        sharded.inject(id++, route, 1500, ttl);
+    }
+
+    auto results = sharded.run();
+    ASSERT_EQ(results.size(), expected.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(results[i].id, i);
+        EXPECT_DOUBLE_EQ(results[i].seconds, expected[i].first);
+        EXPECT_EQ(results[i].ttlLeft, expected[i].second);
+        EXPECT_EQ(results[i].hops, expectedHops[i]);
+        EXPECT_EQ(results[i].delivered, i != 3);
+    }
+    EXPECT_GT(sharded.lastRunStats().crossShardMessages, 0u);
+}
+
+TEST(ShardedSimulationTest, ShardsRunInSeparateProcesses) {
+    NetworkSimulator sim;
+    buildGrid(sim, 8);
+    std::vector<pid_t> pids;
+    {
+        ShardedSimulator sharded = sim.shard(3);
+        ASSERT_EQ(sharded.shardCount(), 3u);
+        for (std::uint32_t s = 0; s < 3; ++s) {
+            pids.push_back(sharded.workerPid(s));
+            EXPECT_GT(pids.back(), 0);
+            EXPECT_NE(pids.back(), ::getpid());
+            EXPECT_EQ(::kill(pids.back(), 0), 0); // процес живий між запусками
+        }
+
+        // воркери тримають свої шарди між запусками: другий запуск на тих самих процесах
+        DijkstraRouting algo;
+        auto route = sim.findRoute(algo, "N0_0", "N7_7", 1500);
+        Packet pkt("N0_0", "N7_7", 64, 1500);
+        const double expected = sim.sendPacket(route, pkt);
+        for (std::uint32_t run = 0; run < 2; ++run) {
+            sharded.inject(run, route, 1500, 64);
+            auto results = sharded.run();
+            ASSERT_EQ(results.size(), 1u);
+            EXPECT_EQ(results[0].id, run);
+            EXPECT_DOUBLE_EQ(results[0].seconds, expected);
+            EXPECT_TRUE(results[0].delivered);
+        }
+        EXPECT_TRUE(sharded.run().empty());
+    }
+    for (pid_t pid : pids) EXPECT_EQ(::kill(pid, 0), -1); // деструктор дочекався завершення воркерів
+}
+
+TEST(ShardedSimulationTest, SimulatorsDestroyedInCreationOrder) {
+    NetworkSimulator sim;
+    buildGrid(sim, 6);
+    auto a = std::make_unique<ShardedSimulator>(*sim.linkArrays(), 2);
+    auto b = std::make_unique<ShardedSimulator>(*sim.linkArrays(), 2); // воркери b не тримають каналів a
+    const pid_t aWorker = a->workerPid(0);
+
+    a.reset(); // раніше зависало у waitpid: воркери b утримували координаторський кінець a
+    EXPECT_EQ(::kill(aWorker, 0), -1);
+
+    DijkstraRouting algo;
+    auto route = sim.findRoute(algo, "N0_0", "N5_5", 1500);
+    b->inject(1, route, 1500, 64);
+    auto results = b->run();
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_TRUE(results[0].delivered);
+    b.reset();
+}
+#endif
+
+// ---------- Binary packet traces ----------
+TEST(PacketTraceTest, RoundTripRawAndCompressed) {
+    std::vector<TraceRecord> records;
+    for (std::uint32_t i = 0; i < 10'000; ++i) {
+        TraceRecord r;
+        r.timestampNs = 1'000'000'000ull + i * 1500ull - (i % 7) * 3000ull; // інколи не монотонно
+        r.packetId = i / 4;
+        r.nodeId = (i * 31) % 977;
+        r.linkId = (i % 4 == 0) ? TraceRecord::noLink : (i * 17) % 4001;
+        r.event = static_cast<TraceEvent>(i % 4);
+        records.push_back(r);
+    }
+
+    const auto dir = std::filesystem::temp_directory_path();
+    std::uintmax_t sizes[2] = {0, 0};
+    for (bool compress : {false, true}) {
+        const auto file = (dir / (compress ? "netsim_trace_z.bin" : "netsim_trace_raw.bin")).string();
+        {
+            PacketTraceWriter w(file, compress, /*blockRecords*/ 4096); // кілька блоків + неповний
+            for (auto& r : records) w.write(r);
+            EXPECT_EQ(w.recordsWritten(), records.size());
+        }
+        sizes[compress] = std::filesystem::file_size(file);
+
+        PacketTraceReader reader(file);
+        EXPECT_EQ(reader.compressed(), compress);
+        std::vector<TraceRecord> back(reader.begin(), reader.end());
+        EXPECT_EQ(back, records);
+        std::filesystem::remove(file);
+    }
+    EXPECT_EQ(sizes[0], 16 + 3 * 8 + records.size() * sizeof(TraceRecord));
+    EXPECT_LT(sizes[1] * 2, sizes[0]);
+}
+
+TEST(PacketTraceTest, CorruptedBlockHeaderIsRejectedBeforeAllocation) {
+    const auto file = (std::filesystem::temp_directory_path() / "netsim_trace_bad.bin").string();
+    // заголовок траси + один заголовок блоку (count, bytes) + bytes нульових байтів даних
+    auto craft = [&](std::uint32_t flags, std::uint32_t count, std::uint32_t bytes, std::size_t data) {
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+        const std::uint32_t header[5] = {1, flags, count, bytes, 0};
+        out.write("NSTRACE1", 8);
+        out.write(reinterpret_cast<const char*>(header), 4 * sizeof(std::uint32_t));
+        out.write(std::string(data, '\0').data(), static_cast<std::streamsize>(data));
+    };
+    auto error = [&]() -> std::string {
+        try {
+            PacketTraceReader reader(file);
+            TraceRecord r;
+            while (reader.next(r)) {}
+        } catch (const std::runtime_error& e) {
+            return e.what();
+        }
+        return "";
+    };
+
+    craft(0, 0x7fffffff, 0x7fffffff, 0);         // сирий: bytes != count * 24
+    EXPECT_EQ(error(), "Corrupted trace block");
+    craft(1, 0x7fffffff, 64, 64);                // стиснений: менше 5 байт на запис
+    EXPECT_EQ(error(), "Corrupted trace block");
+    craft(0, 1u << 20, 24u << 20, 48);           // заголовок узгоджений, але даних немає
+    EXPECT_EQ(error(), "Truncated trace file");
+    craft(0, 2, 48, 48);                         // коректний блок
+    EXPECT_EQ(error(), "");
+    std::filesystem::remove(file);
+}
+
+TEST(PacketTraceTest, TracedSendMatchesSendPacket) {
+    NetworkSimulator sim;
+    sim.buildDemo();
+    DijkstraRouting algo;
+    auto route = sim.findRoute(algo, "H1", "H2", 1500); // H1 S1 R1 H2
+    ASSERT_EQ(route.size(), 4u);
+    LinkArrays links = LinkArrays::fromGraph(*sim.snapshot());
+
+    const auto file = (std::filesystem::temp_directory_path() / "netsim_trace_send.bin").string();
+    Packet plain("H1", "H2", 8, 1500), traced("H1", "H2", 8, 1500), dropped("H1", "H2", 2, 1500);
+    double expected = sim.sendPacket(route, plain);
+    {
+        PacketTraceWriter w(file, true);
+        EXPECT_EQ(sendPacketTraced(links, route, traced, w, 7, 1.0), expected);
+        sendPacketTraced(links, route, dropped, w, 8, 1.0);
+    }
+    EXPECT_EQ(traced.ttl(), plain.ttl());
+    EXPECT_TRUE(traced.hops().empty()); // маршрут — у трасі, а не в рядках
+
+    PacketTraceReader reader(file);
+    std::vector<TraceRecord> events(reader.begin(), reader.end());
+    std::filesystem::remove(file);
+
+    // пакет 7: Inject, 3 x Hop, Deliver; пакет 8: Inject, 2 x Hop, Drop
+    ASSERT_EQ(events.size(), 5u + 4u);
+    EXPECT_EQ(events[0].event, TraceEvent::Inject);
+    EXPECT_EQ(events[0].nodeId, links.topo.indexOf("H1"));
+    EXPECT_EQ(events[0].timestampNs, 1'000'000'000u);
+    for (int i = 1; i <= 3; ++i) {
+        EXPECT_EQ(events[i].event, TraceEvent::Hop);
+        EXPECT_EQ(events[i].nodeId, links.topo.indexOf(route[i]));
+        EXPECT_EQ(links.topo.targets[events[i].linkId], events[i].nodeId);
+    }
+    EXPECT_EQ(events[4].event, TraceEvent::Deliver);
+    EXPECT_EQ(events[4].timestampNs, static_cast<std::uint64_t>(std::llround((1.0 + expected) * 1e9)));
+    EXPECT_EQ(events[8].event, TraceEvent::Drop);
+    EXPECT_EQ(events[8].packetId, 8u);
+    EXPECT_EQ(events[8].nodeId, links.topo.indexOf("R1"));
+}
+
+TEST(PacketTraceTest, UnknownNodeCostsLikeMissingLink) {
+    NetworkSimulator sim;
+    sim.buildDemo();
+    std::shared_ptr<const LinkArrays> links = sim.linkArrays();
+    const std::vector<std::string> route{"H1", "GHOST", "S1", "H1"};
+
+    const auto file = (std::filesystem::temp_directory_path() / "netsim_trace_unknown.bin").string();
+    Packet plain("H1", "H1", 8, 1500), traced("H1", "H1", 8, 1500);
+    const double expected = sim.sendPacket(route, plain); // 1e9 + 1e9 + S1->H1
+    {
+        PacketTraceWriter w(file);
+        EXPECT_EQ(sendPacketTraced(*links, route, traced, w, 1), expected);
+    }
+    EXPECT_EQ(traced.ttl(), plain.ttl());
+
+    PacketTraceReader reader(file);
+    std::vector<TraceRecord> events(reader.begin(), reader.end());
+    std::filesystem::remove(file);
+
+    ASSERT_EQ(events.size(), 5u); // Inject, 3 x Hop, Deliver — траса завершена
+    EXPECT_EQ(events[1].nodeId, TraceRecord::noNode);
+    EXPECT_EQ(events[1].linkId, TraceRecord::noLink);
+    EXPECT_EQ(events[2].nodeId, links->topo.indexOf("S1"));
+    EXPECT_EQ(events[2].linkId, TraceRecord::noLink);
+    EXPECT_NE(events[3].linkId, TraceRecord::noLink);
+    EXPECT_EQ(events[4].event, TraceEvent::Deliver);
+}
+
+TEST(PacketTraceTest, HugeTimestampsSaturate) {
+    // хопи без каналу по 1e9 с: понад ~9.2e9 с наносекунди не вміщаються в long long
+    const auto bigFile = (std::filesystem::temp_directory_path() / "netsim_trace_big.bin").string();
+    {
+        PacketTraceWriter w(bigFile, true);
+        w.write(9.5, 2, 0, TraceRecord::noLink, TraceEvent::Hop);
+        w.write(12.0e9, 2, 0, TraceRecord::noLink, TraceEvent::Hop);  // 1.2e19 нс: > INT64_MAX, < 2^64
+        w.write(25.0e9, 2, 0, TraceRecord::noLink, TraceEvent::Drop); // 2.5e19 нс: насичення
+    }
+    PacketTraceReader big(bigFile);
+    std::vector<TraceRecord> saturated(big.begin(), big.end());
+    std::filesystem::remove(bigFile);
+    ASSERT_EQ(saturated.size(), 3u);
+    EXPECT_EQ(saturated[0].timestampNs, 9'500'000'000u);
+    EXPECT_EQ(saturated[1].timestampNs, 12'000'000'000'000'000'000u);
+    EXPECT_EQ(saturated[2].timestampNs, std::numeric_limits<std::uint64_t>::max());
+}